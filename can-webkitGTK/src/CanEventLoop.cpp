@@ -0,0 +1,116 @@
+#include "CanEventLoop.h"
+#include <cerrno>
+#include <ctime>
+#include <vector>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+static int64_t monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+CanEventLoop::CanEventLoop() {
+    m_epfd = epoll_create1(EPOLL_CLOEXEC);
+    m_timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (m_epfd < 0 || m_timerfd < 0) return;
+
+    struct epoll_event ev {};
+    ev.events = EPOLLIN;
+    ev.data.fd = m_timerfd;
+    epoll_ctl(m_epfd, EPOLL_CTL_ADD, m_timerfd, &ev);
+}
+
+CanEventLoop::~CanEventLoop() {
+    if (m_timerfd >= 0) close(m_timerfd);
+    if (m_epfd >= 0) close(m_epfd);
+}
+
+bool CanEventLoop::Watch(int fd, uint32_t events, IoHandler handler) {
+    struct epoll_event ev {};
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(m_epfd, EPOLL_CTL_ADD, fd, &ev) < 0) return false;
+    m_watches[fd] = std::move(handler);
+    return true;
+}
+
+bool CanEventLoop::Modify(int fd, uint32_t events) {
+    struct epoll_event ev {};
+    ev.events = events;
+    ev.data.fd = fd;
+    return epoll_ctl(m_epfd, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+void CanEventLoop::Unwatch(int fd) {
+    if (m_watches.erase(fd)) epoll_ctl(m_epfd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+CanEventLoop::TimerId CanEventLoop::AddTimer(int ms, TimerHandler handler) {
+    TimerId id = m_nextTimer++;
+    m_timers[id] = Timer{monotonic_ns() + static_cast<int64_t>(ms) * 1000000, std::move(handler)};
+    ArmTimerFd();
+    return id;
+}
+
+void CanEventLoop::CancelTimer(TimerId id) {
+    if (m_timers.erase(id)) ArmTimerFd();
+}
+
+void CanEventLoop::ArmTimerFd() {
+    struct itimerspec its {};
+    if (!m_timers.empty()) {
+        int64_t next = m_timers.begin()->second.deadlineNs;
+        for (const auto& entry : m_timers) {
+            if (entry.second.deadlineNs < next) next = entry.second.deadlineNs;
+        }
+        /* 绝对时间已过时立即触发；it_value 全 0 表示停止，故至少为 1 ns */
+        if (next <= 0) next = 1;
+        its.it_value.tv_sec = next / 1000000000;
+        its.it_value.tv_nsec = next % 1000000000;
+    }
+    timerfd_settime(m_timerfd, TFD_TIMER_ABSTIME, &its, nullptr);
+}
+
+void CanEventLoop::RunTimers() {
+    if (m_timers.empty()) return;
+
+    int64_t now = monotonic_ns();
+    std::vector<TimerId> due;
+    for (const auto& entry : m_timers) {
+        if (entry.second.deadlineNs <= now) due.push_back(entry.first);
+    }
+    for (TimerId id : due) {
+        /* 前一个回调可能已取消该定时器 */
+        auto it = m_timers.find(id);
+        if (it == m_timers.end()) continue;
+        TimerHandler handler = std::move(it->second.handler);
+        m_timers.erase(it);
+        handler();
+    }
+    if (!due.empty()) ArmTimerFd();
+}
+
+void CanEventLoop::Dispatch(int timeoutMs) {
+    struct epoll_event events[16];
+    int n = epoll_wait(m_epfd, events, 16, timeoutMs);
+    if (n < 0 && errno != EINTR) return;
+
+    for (int i = 0; i < n; i++) {
+        int fd = events[i].data.fd;
+        if (fd == m_timerfd) {
+            uint64_t expirations;
+            while (read(m_timerfd, &expirations, sizeof(expirations)) > 0) {}
+            continue;
+        }
+        /* 前一个回调可能已注销该 fd；回调内也可能注销自己，先复制一份 */
+        auto it = m_watches.find(fd);
+        if (it == m_watches.end()) continue;
+        IoHandler handler = it->second;
+        handler(events[i].events);
+    }
+    RunTimers();
+}
+
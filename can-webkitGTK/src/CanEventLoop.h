@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+#include <map>
+
+/**
+ * 单线程 epoll 事件循环：fd 就绪回调和毫秒定时器（timerfd 同样注册在 epoll 中）。
+ * Fd() 可读即表示有事件待处理，交给 GLib 主循环 (g_unix_fd_add) 驱动。
+ * 回调中可以增删 fd 和定时器。
+ */
+class CanEventLoop {
+public:
+    using IoHandler = std::function<void(uint32_t events)>;
+    using TimerHandler = std::function<void()>;
+    using TimerId = uint64_t;
+
+    CanEventLoop();
+    ~CanEventLoop();
+
+    CanEventLoop(const CanEventLoop&) = delete;
+    CanEventLoop& operator=(const CanEventLoop&) = delete;
+
+    bool Valid() const { return m_epfd >= 0 && m_timerfd >= 0; }
+    int Fd() const { return m_epfd; }
+
+    bool Watch(int fd, uint32_t events, IoHandler handler);
+    bool Modify(int fd, uint32_t events);
+    void Unwatch(int fd);
+
+    /** 返回非 0 的定时器 ID，到期后自动移除 */
+    TimerId AddTimer(int ms, TimerHandler handler);
+    void CancelTimer(TimerId id);
+
+    /** 处理一批就绪事件和到期定时器；timeoutMs 为 -1 时阻塞等待 */
+    void Dispatch(int timeoutMs);
+
+private:
+    struct Timer {
+        int64_t deadlineNs;
+        TimerHandler handler;
+    };
+
+    void ArmTimerFd();
+    void RunTimers();
+
+    int m_epfd = -1;
+    int m_timerfd = -1;
+    std::map<int, IoHandler> m_watches;
+    std::map<TimerId, Timer> m_timers;  /* 同时在途的定时器很少，按 ID 存放，到期时线性扫描 */
+    TimerId m_nextTimer = 1;
+};
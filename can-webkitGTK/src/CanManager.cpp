@@ -1,15 +1,23 @@
 #include "CanManager.h"
+#include "CanNetlink.h"
+#include "CanTransfer.h"
+#include "FirmwareImage.h"
+#include <cerrno>
 #include <cstdio>
 #include <cstdarg>
 #include <cstring>
+#include <algorithm>
+#include <chrono>
 #include <unistd.h>
 #include <dirent.h>
 #include <fcntl.h>
+#include <sys/epoll.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
-#include <sys/select.h>
 #include <linux/can.h>
 #include <linux/can/raw.h>
+#include <poll.h>
+#include <linux/net_tstamp.h>
 #include <net/if.h>
 
 static const int BAUD_RATES[] = {
@@ -17,14 +25,20 @@ static const int BAUD_RATES[] = {
     125000, 250000, 500000, 1000000
 };
 
-CanManager::CanManager() = default;
+static const int ACK_TIMEOUT_MS = 5000;
+static const int CMD_SEND_RETRY_MS = 50;   /* 控制帧遇到发送队列满时的最长重试时间 */
+
+CanManager::CanManager(CanEventLoop& loop) : m_loop(loop) {}
 
 CanManager::~CanManager() {
+    /* 进程退出路径：不再恢复等待中的协程 */
+    AbortWaiters("CAN 已断开", false);
     Disconnect();
 }
 
 void CanManager::SetLogCallback(LogCallback cb) { m_logCb = std::move(cb); }
 void CanManager::SetProgressCallback(ProgressCallback cb) { m_progressCb = std::move(cb); }
+void CanManager::SetDisconnectCallback(DisconnectCallback cb) { m_disconnectCb = std::move(cb); }
 
 void CanManager::Log(const char* msg) {
     if (m_logCb) m_logCb(msg);
@@ -65,7 +79,6 @@ std::vector<std::string> CanManager::DetectDevices() {
 }
 
 bool CanManager::Connect(const std::string& interface, int baudrateIndex) {
-    std::lock_guard<std::mutex> lock(m_mutex);
     if (m_fd >= 0) {
         Log("已连接，请先断开");
         return false;
@@ -76,30 +89,34 @@ bool CanManager::Connect(const std::string& interface, int baudrateIndex) {
     }
 
     int bitrate = BAUD_RATES[baudrateIndex];
-    std::string cmd = "ip link set " + interface + " type can bitrate " + std::to_string(bitrate) + " 2>/dev/null";
-    int ret = system(cmd.c_str());
-    if (ret != 0) {
-        LogFmt("设置波特率 %d 失败 (可能需要 root)", bitrate);
-    }
-
-    cmd = "ip link set " + interface + " up 2>/dev/null";
-    ret = system(cmd.c_str());
-    if (ret != 0) {
-        LogFmt("启动接口 %s 失败", interface.c_str());
+    CanLinkInfo link;
+    std::string error;
+    auto t0 = std::chrono::steady_clock::now();
+    bool configured = CanLinkConfigure(interface, static_cast<uint32_t>(bitrate), link, error);
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+    if (!configured) {
+        Log(error.c_str());
+    } else {
+        if (!link.isCan) {
+            LogFmt("%s 为虚拟接口，忽略波特率设置", interface.c_str());
+        }
+        LogFmt("接口配置耗时 %lld us", static_cast<long long>(us));
     }
 
     struct ifreq ifr {};
     struct sockaddr_can addr {};
 
-    m_fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    m_fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
     if (m_fd < 0) {
         Log("创建 CAN socket 失败");
         m_fd = -1;
         return false;
     }
 
+    /* 接口索引已由 rtnetlink 查询得到，配置失败时才用 ioctl 查询 */
     strncpy(ifr.ifr_name, interface.c_str(), IFNAMSIZ - 1);
-    if (ioctl(m_fd, SIOCGIFINDEX, &ifr) < 0) {
+    ifr.ifr_ifindex = link.ifindex;
+    if (ifr.ifr_ifindex <= 0 && ioctl(m_fd, SIOCGIFINDEX, &ifr) < 0) {
         Log("获取接口索引失败");
         close(m_fd);
         m_fd = -1;
@@ -120,93 +137,237 @@ bool CanManager::Connect(const std::string& interface, int baudrateIndex) {
     rfilter[0].can_mask = 0x7FF;
     setsockopt(m_fd, SOL_CAN_RAW, CAN_RAW_FILTER, &rfilter, sizeof(rfilter));
 
+    /* 错误帧驱动发送节奏：错误被动、总线关闭时降速 */
+    can_err_mask_t errMask = CAN_PACER_ERR_MASK;
+    if (setsockopt(m_fd, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &errMask, sizeof(errMask)) < 0) {
+        Log("订阅 CAN 错误帧失败，仅按发送队列调节速率");
+    }
+    m_busState = CanBusState::Active;
+
+    /* 内核接收时间戳用于统计 ACK 往返时延，排除线程唤醒延迟 */
+    int tsFlags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (setsockopt(m_fd, SOL_SOCKET, SO_TIMESTAMPING, &tsFlags, sizeof(tsFlags)) < 0) {
+        Log("启用接收时间戳失败，往返时延改用用户态时间");
+    }
+
+    if (!m_loop.Watch(m_fd, EPOLLIN, [this](uint32_t events) { OnSocketEvent(events); })) {
+        Log("注册 CAN socket 事件失败");
+        close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+    m_armedEvents = EPOLLIN;
+
+    m_rx.SetFd(m_fd);
     m_interface = interface;
+    m_bitrate = bitrate;
     LogFmt("已连接 %s, 波特率 %d", interface.c_str(), bitrate);
     return true;
 }
 
 void CanManager::Disconnect() {
-    std::lock_guard<std::mutex> lock(m_mutex);
     if (m_fd >= 0) {
+        m_loop.Unwatch(m_fd);
         close(m_fd);
         m_fd = -1;
-        if (!m_interface.empty()) {
-            std::string cmd = "ip link set " + m_interface + " down 2>/dev/null";
-            system(cmd.c_str());
+        m_rx.SetFd(-1);
+        std::string error;
+        if (!m_interface.empty() && !CanLinkSetUp(m_interface, false, error)) {
+            Log(error.c_str());
         }
         m_interface.clear();
         Log("已断开连接");
     }
+    AbortWaiters("CAN 已断开", true);
 }
 
-static void pack_u32(uint8_t* buf, uint32_t v1, uint32_t v2) {
-    buf[0] = (v1 >> 24) & 0xff; buf[1] = (v1 >> 16) & 0xff;
-    buf[2] = (v1 >> 8) & 0xff; buf[3] = v1 & 0xff;
-    buf[4] = (v2 >> 24) & 0xff; buf[5] = (v2 >> 16) & 0xff;
-    buf[6] = (v2 >> 8) & 0xff; buf[7] = v2 & 0xff;
-}
-
-static void unpack_u32(const uint8_t* buf, uint32_t* v1, uint32_t* v2) {
-    *v1 = (uint32_t(buf[0]) << 24) | (uint32_t(buf[1]) << 16) | (uint32_t(buf[2]) << 8) | uint32_t(buf[3]);
-    *v2 = (uint32_t(buf[4]) << 24) | (uint32_t(buf[5]) << 16) | (uint32_t(buf[6]) << 8) | uint32_t(buf[7]);
-}
-
+/* 单个控制帧：发送队列满时短暂重试而不是丢弃，否则只能等响应超时 */
 static int can_send(int fd, uint32_t id, const uint8_t* data, uint8_t dlc) {
     struct can_frame frame {};
     frame.can_id = id;
     frame.can_dlc = dlc;
     if (data && dlc > 0) memcpy(frame.data, data, dlc);
-    ssize_t nbytes = write(fd, &frame, sizeof(frame));
-    return (nbytes == sizeof(frame)) ? 0 : -1;
+    for (int waited = 0;;) {
+        ssize_t nbytes = write(fd, &frame, sizeof(frame));
+        if (nbytes == sizeof(frame)) return 0;
+        if (nbytes >= 0) return -1;
+        int err = errno;
+        if (err == EINTR) continue;
+        if ((err != EAGAIN && err != EWOULDBLOCK && err != ENOBUFS) || waited >= CMD_SEND_RETRY_MS) return -1;
+        /* EAGAIN 可等到可写；ENOBUFS 时 socket 仍报告可写，只能定时重试 */
+        struct pollfd pfd = {fd, POLLOUT, 0};
+        poll(err == ENOBUFS ? nullptr : &pfd, err == ENOBUFS ? 0 : 1, 1);
+        waited++;
+    }
 }
 
-static int can_recv(int fd, uint32_t* code, uint32_t* val, int timeoutMs) {
-    fd_set readfds;
-    struct timeval tv {};
-    struct can_frame frame {};
+void CanManager::ResponseAwaiter::await_suspend(std::coroutine_handle<> h) {
+    m_handle = h;
+    m_mgr.m_waiters.push_back(this);
+    m_timer = m_mgr.m_loop.AddTimer(m_timeoutMs, [this]() {
+        auto& waiters = m_mgr.m_waiters;
+        waiters.erase(std::find(waiters.begin(), waiters.end(), this));
+        m_handle.resume();
+    });
+}
 
-    FD_ZERO(&readfds);
-    FD_SET(fd, &readfds);
-    tv.tv_sec = timeoutMs / 1000;
-    tv.tv_usec = (timeoutMs % 1000) * 1000;
+bool CanManager::TransferAwaiter::await_suspend(std::coroutine_handle<> h) {
+    m_mgr.m_transfer = &m_transfer;
+    m_mgr.m_transferHandle = h;
+    m_mgr.UpdateTransfer();
+    /* 首次发送即失败时不挂起 */
+    if (!m_mgr.m_transfer) {
+        m_mgr.m_ready.pop_back();
+        return false;
+    }
+    return true;
+}
 
-    int ret = select(fd + 1, &readfds, nullptr, nullptr, &tv);
-    if (ret <= 0) return -1;
+/* 读出并清除 socket 的挂起错误 (SO_ERROR)，没有时返回 ENETDOWN */
+static int take_socket_error(int fd) {
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err == 0) return ENETDOWN;
+    return err;
+}
 
-    ssize_t nbytes = read(fd, &frame, sizeof(frame));
-    if (nbytes < 0) return -1;
+void CanManager::OnSocketEvent(uint32_t events) {
+    /* 本次唤醒的 epoll_wait 与 recvmmsg 计入传输统计 */
+    size_t before = m_rx.Syscalls();
+    int err = 0;
+    if (events & EPOLLIN) {
+        int n = m_rx.Drain([this](const struct can_frame& frame, int64_t rxNs) { OnFrame(frame, rxNs); });
+        if (n < 0) err = errno;
+    }
+    if (m_transfer) m_transfer->AddSyscalls(m_rx.Syscalls() - before + 1);
+
+    /* 接口关闭或适配器拔出：fd 为水平触发，错误不清除会让主循环空转，直接断开 */
+    if (err == 0 && (events & (EPOLLERR | EPOLLHUP))) err = take_socket_error(m_fd);
+    if (err != 0) {
+        LogFmt("CAN 接口错误: %s", strerror(err));
+        AbortWaiters("CAN 接口错误", true);
+        Disconnect();
+        if (m_disconnectCb) m_disconnectCb();
+        return;
+    }
 
-    unpack_u32(frame.data, code, val);
-    return 0;
+    if (m_transfer) UpdateTransfer();
+    ResumeReady();
 }
 
-bool CanManager::WaitResponse(uint32_t& code, uint32_t& val, int timeoutMs) {
-    return can_recv(m_fd, &code, &val, timeoutMs) == 0;
+void CanManager::OnFrame(const struct can_frame& frame, int64_t rxNs) {
+    if (frame.can_id & CAN_ERR_FLAG) {
+        CanBusState state = CanPacer::Classify(frame, m_busState);
+        if (state != m_busState) {
+            m_busState = state;
+            LogFmt("CAN 控制器状态: %s", CanBusStateName(state));
+        }
+        if (m_transfer) m_transfer->OnFrame(frame, rxNs);
+        return;
+    }
+
+    /* 先交给等待中的请求（版本查询可与升级并行），其余归传输 */
+    for (auto it = m_waiters.begin(); it != m_waiters.end(); ++it) {
+        ResponseAwaiter* waiter = *it;
+        if (!waiter->m_slot.Match(frame)) continue;
+        m_waiters.erase(it);
+        m_loop.CancelTimer(waiter->m_timer);
+        m_ready.push_back(waiter->m_handle);
+        return;
+    }
+    if (m_transfer) m_transfer->OnFrame(frame, rxNs);
 }
 
-uint32_t CanManager::GetFirmwareVersion() {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    if (!CheckConnected()) return 0;
+void CanManager::UpdateTransfer() {
+    CanTransfer* t = m_transfer;
+    if (!t->Done() && !t->Failed()) t->OnWritable();
+
+    /* 超时检查定时器：到期时重算剩余时间；ENOBUFS 或限速时到点重试发送 */
+    if (!t->Done() && !t->Failed() && (m_transferTimer == 0 || t->Throttled())) {
+        m_loop.CancelTimer(m_transferTimer);
+        m_transferTimer = 0;
+        int ms = t->CheckTimeout(ACK_TIMEOUT_MS);
+        if (t->Throttled() && ms > t->ThrottleMs()) ms = t->ThrottleMs();
+        if (!t->Failed()) {
+            m_transferTimer = m_loop.AddTimer(ms, [this]() {
+                m_transferTimer = 0;
+                if (!m_transfer) return;
+                m_transfer->AddSyscalls(1);
+                UpdateTransfer();
+                ResumeReady();
+            });
+        }
+    }
+
+    if (t->Done() || t->Failed()) {
+        FinishTransfer();
+        return;
+    }
+
+    uint32_t want = EPOLLIN | (t->Blocked() ? EPOLLOUT : 0u);
+    if (want != m_armedEvents) {
+        m_loop.Modify(m_fd, want);
+        m_armedEvents = want;
+    }
+}
+
+void CanManager::FinishTransfer() {
+    m_loop.CancelTimer(m_transferTimer);
+    m_transferTimer = 0;
+    if (m_fd >= 0 && m_armedEvents != EPOLLIN) {
+        m_loop.Modify(m_fd, EPOLLIN);
+        m_armedEvents = EPOLLIN;
+    }
+    m_transfer = nullptr;
+    m_ready.push_back(std::exchange(m_transferHandle, {}));
+}
+
+void CanManager::ResumeReady() {
+    while (!m_ready.empty()) {
+        std::vector<std::coroutine_handle<>> ready;
+        ready.swap(m_ready);
+        for (auto h : ready) h.resume();
+    }
+}
+
+void CanManager::AbortWaiters(const char* reason, bool resume) {
+    for (ResponseAwaiter* waiter : m_waiters) {
+        m_loop.CancelTimer(waiter->m_timer);
+        m_ready.push_back(waiter->m_handle);
+    }
+    m_waiters.clear();
+    if (m_transfer) {
+        m_transfer->Abort(reason);
+        FinishTransfer();
+    }
+    if (resume) {
+        ResumeReady();
+    } else {
+        m_ready.clear();
+    }
+}
+
+Task<uint32_t> CanManager::Version() {
+    if (!CheckConnected()) co_return 0;
 
     uint8_t data[8] = {};
     pack_u32(data, BOARD_VERSION, 0);
-    can_send(m_fd, PLATFORM_RX, data, 8);
+    if (can_send(m_fd, PLATFORM_RX, data, 8) < 0) {
+        LogFmt("发送命令失败: %s", strerror(errno));
+        co_return 0;
+    }
 
-    uint32_t code = 0, version = 0;
-    if (!WaitResponse(code, version, 5000)) {
+    CanPending slot(CanPending::CodeBit(FW_CODE_VERSION));
+    if (!co_await WaitResponse(slot, 5000)) {
         Log("获取版本超时");
-        return 0;
+        co_return 0;
     }
-    if (code == FW_CODE_VERSION) {
-        LogFmt("固件版本: v%u.%u.%u", (version >> 24) & 0xFF, (version >> 16) & 0xFF, (version >> 8) & 0xFF);
-        return version;
-    }
-    Log("获取版本失败");
-    return 0;
+    uint32_t version = slot.val;
+    LogFmt("固件版本: v%u.%u.%u", (version >> 24) & 0xFF, (version >> 16) & 0xFF, (version >> 8) & 0xFF);
+    co_return version;
 }
 
 bool CanManager::BoardReboot() {
-    std::lock_guard<std::mutex> lock(m_mutex);
     if (!CheckConnected()) return false;
 
     uint8_t data[8] = {};
@@ -218,85 +379,103 @@ bool CanManager::BoardReboot() {
     return false;
 }
 
-bool CanManager::FirmwareUpgrade(const std::string& fileName, bool testMode) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    if (!CheckConnected()) return false;
+Task<bool> CanManager::Upgrade(std::string fileName, bool testMode) {
+    if (!CheckConnected()) co_return false;
 
-    FILE* fp = fopen(fileName.c_str(), "rb");
-    if (!fp) {
-        LogFmt("无法打开文件: %s", fileName.c_str());
-        return false;
+    FirmwareImage image;
+    std::string error;
+    if (!image.Open(fileName, error)) {
+        Log(error.c_str());
+        co_return false;
     }
+    LogFmt("固件大小: %zu 字节", image.Size());
+    co_return co_await Upgrade(image, testMode);
+}
 
-    fseek(fp, 0, SEEK_END);
-    long fileSize = ftell(fp);
-    fseek(fp, 0, SEEK_SET);
+Task<bool> CanManager::Upgrade(const FirmwareImage& image, bool testMode) {
+    if (!CheckConnected()) co_return false;
+    if (m_upgrading) {
+        Log("升级进行中");
+        co_return false;
+    }
+    m_upgrading = true;
+    bool ok = co_await RunUpgrade(image, testMode);
+    m_upgrading = false;
+    co_return ok;
+}
 
-    LogFmt("固件大小: %ld 字节", fileSize);
+Task<bool> CanManager::RunUpgrade(const FirmwareImage& image, bool testMode) {
+    m_lastStats = TransferStats();
 
     uint8_t data[8] = {};
-    uint32_t code = 0, val = 0;
-
-    pack_u32(data, BOARD_START_UPDATE, static_cast<uint32_t>(fileSize));
-    can_send(m_fd, PLATFORM_RX, data, 8);
+    pack_u32(data, BOARD_START_UPDATE, static_cast<uint32_t>(image.Size()));
+    if (can_send(m_fd, PLATFORM_RX, data, 8) < 0) {
+        LogFmt("发送命令失败: %s", strerror(errno));
+        co_return false;
+    }
 
-    if (!WaitResponse(code, val, 5000)) {
-        fclose(fp);
+    /* 擦除完成回 OFFSET(0)；上次中断的传输残留的 OFFSET(n) 按偏移丢弃 */
+    CanPending erase(CanPending::CodeBit(FW_CODE_OFFSET) | CanPending::CodeBit(FW_CODE_FLASH_ERROR) |
+                     CanPending::CodeBit(FW_CODE_TRANFER_ERROR));
+    erase.maxOffset = 0;
+    if (!co_await WaitResponse(erase, 5000)) {
         Log("等待板卡响应超时");
-        return false;
+        co_return false;
     }
-    if (code != FW_CODE_OFFSET || val != 0) {
-        fclose(fp);
-        LogFmt("Flash 擦除错误: code=%u, offset=%u", code, val);
-        return false;
+    if (erase.code != FW_CODE_OFFSET) {
+        LogFmt("Flash 擦除错误: code=%u, offset=%u", erase.code, erase.val);
+        co_return false;
     }
 
     Log("开始传输固件数据...");
-    size_t sent = 0;
-    while (true) {
-        size_t nread = fread(data, 1, 8, fp);
-        if (nread == 0) break;
-
-        can_send(m_fd, FW_DATA_RX, data, static_cast<uint8_t>(nread));
-        sent += nread;
-
-        if (m_progressCb) {
-            int percent = static_cast<int>(sent * 100 / fileSize);
+    CanTransfer transfer(m_fd, image, m_bitrate);
+    int lastPercent = -1;
+    transfer.SetProgressCallback([this, &lastPercent](size_t acked, size_t total) {
+        int percent = static_cast<int>(acked * 100 / total);
+        if (m_progressCb && percent != lastPercent) {
+            lastPercent = percent;
             m_progressCb(percent);
         }
-
-        if (sent % 64 != 0 && static_cast<long>(sent) < fileSize) continue;
-
-        if (!WaitResponse(code, val, 5000)) {
-            fclose(fp);
-            Log("传输超时");
-            return false;
-        }
-
-        if (code == FW_CODE_UPDATE_SUCCESS && val == sent) break;
-        if (code != FW_CODE_OFFSET) {
-            fclose(fp);
-            LogFmt("固件上传错误: code=%u, offset=%u", code, val);
-            return false;
-        }
+    });
+
+    bool ok = co_await TransferAwaiter(*this, transfer);
+    const TransferStats& st = transfer.Stats();
+    m_lastStats = st;
+    if (!ok) {
+        LogFmt("固件上传错误: %s (已确认 %zu/%zu 字节)", transfer.Error(), transfer.Acked(), st.bytes);
+        co_return false;
+    }
+    LogFmt("传输完成: %.2f s, %.1f KB/s, 总线利用率 %.1f%%, 重传 %zu 次, 降速 %zu 次, 系统调用 %.0f 次/MB",
+           st.seconds, st.bytes / 1024.0 / st.seconds, st.busLoad, st.resumes, st.backoffs,
+           st.syscalls * 1048576.0 / st.bytes);
+    if (st.errorFrames > 0) {
+        LogFmt("传输期间收到 %zu 个总线错误帧", st.errorFrames);
+    }
+    if (st.rtt.Count() > 0) {
+        LogFmt("ACK 往返: p50 %.2f ms, p99 %.2f ms, max %.2f ms (%llu 次)",
+               st.rtt.Percentile(50) / 1000.0, st.rtt.Percentile(99) / 1000.0,
+               st.rtt.Max() / 1000.0, static_cast<unsigned long long>(st.rtt.Count()));
     }
-
-    fclose(fp);
 
     pack_u32(data, BOARD_CONFIRM, testMode ? 0u : 1u);
-    can_send(m_fd, PLATFORM_RX, data, 8);
+    if (can_send(m_fd, PLATFORM_RX, data, 8) < 0) {
+        LogFmt("发送命令失败: %s", strerror(errno));
+        co_return false;
+    }
 
-    if (!WaitResponse(code, val, 30000)) {
+    /* 传输结束后迟到的 OFFSET/UPDATE_SUCCESS 不会被当作确认响应 */
+    CanPending confirm(CanPending::CodeBit(FW_CODE_CONFIRM) | CanPending::CodeBit(FW_CODE_TRANFER_ERROR));
+    if (!co_await WaitResponse(confirm, 30000)) {
         Log("确认超时");
-        return false;
+        co_return false;
     }
 
-    if (code == FW_CODE_CONFIRM && val == 0x55AA55AA) {
+    if (confirm.code == FW_CODE_CONFIRM && confirm.val == 0x55AA55AA) {
         Log("固件上传完成！请重启板子以完成升级，约需 45-90 秒");
-        return true;
+        co_return true;
     }
-    if (code == FW_CODE_TRANFER_ERROR) {
+    if (confirm.code == FW_CODE_TRANFER_ERROR) {
         Log("下载失败");
     }
-    return false;
+    co_return false;
 }
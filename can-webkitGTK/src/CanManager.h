@@ -1,30 +1,28 @@
 #pragma once
 
 #include <stdint.h>
+#include <coroutine>
 #include <string>
 #include <vector>
 #include <functional>
-#include <mutex>
 
-#define PLATFORM_RX     0x101
-#define PLATFORM_TX     0x102
-#define FW_DATA_RX      0x103
+#include "CanEventLoop.h"
+#include "CanPacer.h"
+#include "CanProtocol.h"
+#include "CanReceiver.h"
+#include "CanTransfer.h"
+#include "Task.h"
 
-#define BOARD_START_UPDATE  0
-#define BOARD_CONFIRM       1
-#define BOARD_VERSION       2
-#define BOARD_REBOOT        3
-
-#define FW_CODE_OFFSET          0
-#define FW_CODE_UPDATE_SUCCESS  1
-#define FW_CODE_VERSION         2
-#define FW_CODE_CONFIRM         3
-#define FW_CODE_FLASH_ERROR     4
-#define FW_CODE_TRANFER_ERROR   5
+class FirmwareImage;
 
+/**
+ * 单个 CAN 接口上的板卡操作。所有方法在事件循环所在线程调用，
+ * 耗时操作以协程返回：co_await mgr.Version() / co_await mgr.Upgrade(...)，
+ * 等待期间不占用线程，升级过程中仍可查询版本。
+ */
 class CanManager {
 public:
-    CanManager();
+    explicit CanManager(CanEventLoop& loop);
     ~CanManager();
 
     CanManager(const CanManager&) = delete;
@@ -32,29 +30,94 @@ public:
 
     using LogCallback = std::function<void(const char*)>;
     using ProgressCallback = std::function<void(int)>;
+    using DisconnectCallback = std::function<void()>;
 
     void SetLogCallback(LogCallback cb);
     void SetProgressCallback(ProgressCallback cb);
+    /** 接口出错（关闭、拔出）被动断开时调用，主动 Disconnect() 不调用 */
+    void SetDisconnectCallback(DisconnectCallback cb);
 
     std::vector<std::string> DetectDevices();
 
     /** baudrateIndex: 0=10K,1=20K,2=50K,3=100K,4=125K,5=250K,6=500K,7=1M */
     bool Connect(const std::string& interface, int baudrateIndex);
 
+    /** 等待中的协程以失败结果恢复 */
     void Disconnect();
-    uint32_t GetFirmwareVersion();
     bool BoardReboot();
-    bool FirmwareUpgrade(const std::string& fileName, bool testMode);
+
+    /** 返回固件版本，超时或未连接时为 0 */
+    Task<uint32_t> Version();
+    Task<bool> Upgrade(std::string fileName, bool testMode);
+    /** 使用已打开的镜像升级，image 须在升级期间保持有效（多接口共用一份帧表） */
+    Task<bool> Upgrade(const FirmwareImage& image, bool testMode);
+    bool Upgrading() const { return m_upgrading; }
+
+    /** 最近一次固件传输的统计（耗时、总线利用率、ACK 往返时延分布） */
+    const TransferStats& LastTransferStats() const { return m_lastStats; }
 
 private:
+    /** co_await 等待 slot 完成或超时，结果为 slot.done */
+    class ResponseAwaiter {
+    public:
+        ResponseAwaiter(CanManager& mgr, CanPending& slot, int timeoutMs)
+            : m_mgr(mgr), m_slot(slot), m_timeoutMs(timeoutMs) {}
+        bool await_ready() const noexcept { return m_mgr.m_fd < 0; }
+        void await_suspend(std::coroutine_handle<> h);
+        bool await_resume() const noexcept { return m_slot.done; }
+
+    private:
+        friend class CanManager;
+        CanManager& m_mgr;
+        CanPending& m_slot;
+        int m_timeoutMs;
+        std::coroutine_handle<> m_handle;
+        CanEventLoop::TimerId m_timer = 0;
+    };
+
+    /** co_await 运行 CanTransfer 直到完成或失败，结果为 Done() */
+    class TransferAwaiter {
+    public:
+        TransferAwaiter(CanManager& mgr, CanTransfer& transfer) : m_mgr(mgr), m_transfer(transfer) {}
+        bool await_ready() const noexcept { return m_mgr.m_fd < 0; }
+        bool await_suspend(std::coroutine_handle<> h);
+        bool await_resume() const noexcept { return m_transfer.Done(); }
+
+    private:
+        CanManager& m_mgr;
+        CanTransfer& m_transfer;
+    };
+
     bool CheckConnected();
     void Log(const char* msg);
     void LogFmt(const char* fmt, ...);
-    bool WaitResponse(uint32_t& code, uint32_t& val, int timeoutMs);
+    ResponseAwaiter WaitResponse(CanPending& slot, int timeoutMs) { return {*this, slot, timeoutMs}; }
 
+    Task<bool> RunUpgrade(const FirmwareImage& image, bool testMode);
+    void OnSocketEvent(uint32_t events);
+    void OnFrame(const struct can_frame& frame, int64_t rxNs);
+    void UpdateTransfer();
+    void FinishTransfer();
+    void ResumeReady();
+    /** 等待中的请求和传输以失败结束；resume 为 false 时不恢复协程 */
+    void AbortWaiters(const char* reason, bool resume);
+
+    CanEventLoop& m_loop;
     int m_fd = -1;
+    int m_bitrate = 0;
+    uint32_t m_armedEvents = 0;
+    CanBusState m_busState = CanBusState::Active;
+    CanReceiver m_rx;
     std::string m_interface;
-    std::mutex m_mutex;
     LogCallback m_logCb;
     ProgressCallback m_progressCb;
+    DisconnectCallback m_disconnectCb;
+
+    std::vector<ResponseAwaiter*> m_waiters;
+    CanTransfer* m_transfer = nullptr;
+    std::coroutine_handle<> m_transferHandle;
+    CanEventLoop::TimerId m_transferTimer = 0;
+    std::vector<std::coroutine_handle<>> m_ready;   /* 分发结束后统一恢复，避免在遍历中重入 */
+    bool m_upgrading = false;
+    TransferStats m_lastStats;
 };
@@ -0,0 +1,204 @@
+#include "CanNetlink.h"
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
+#include <linux/can/netlink.h>
+
+namespace {
+
+struct LinkRequest {
+    struct nlmsghdr nh;
+    struct ifinfomsg ifi;
+    char attrs[256];
+};
+
+struct rtattr* AddAttr(struct nlmsghdr* nh, int type, const void* data, size_t len) {
+    size_t offset = NLMSG_ALIGN(nh->nlmsg_len);
+    if (offset + RTA_SPACE(len) > sizeof(LinkRequest)) return nullptr;
+    auto* rta = reinterpret_cast<struct rtattr*>(reinterpret_cast<char*>(nh) + offset);
+    rta->rta_type = static_cast<unsigned short>(type);
+    rta->rta_len = static_cast<unsigned short>(RTA_LENGTH(len));
+    if (len) memcpy(RTA_DATA(rta), data, len);
+    nh->nlmsg_len = static_cast<uint32_t>(offset + RTA_SPACE(len));
+    return rta;
+}
+
+void EndNest(struct nlmsghdr* nh, struct rtattr* nest) {
+    nest->rta_len = static_cast<unsigned short>(reinterpret_cast<char*>(nh) + nh->nlmsg_len -
+                                                reinterpret_cast<char*>(nest));
+}
+
+void InitRequest(LinkRequest& req, uint16_t type, uint16_t flags, const std::string& ifname) {
+    memset(&req, 0, sizeof(req));
+    req.nh.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    req.nh.nlmsg_type = type;
+    req.nh.nlmsg_flags = NLM_F_REQUEST | flags;
+    req.ifi.ifi_family = AF_UNSPEC;
+    AddAttr(&req.nh, IFLA_IFNAME, ifname.c_str(), ifname.size() + 1);
+}
+
+std::string FormatError(const char* what, const std::string& ifname, int err) {
+    std::string msg = std::string(what) + " " + ifname + " 失败: " + strerror(err);
+    if (err == EPERM || err == EACCES) msg += " (需要 root 或 CAP_NET_ADMIN)";
+    else if (err == ENODEV) msg += " (接口不存在)";
+    else if (err == EBUSY) msg += " (接口正在使用)";
+    return msg;
+}
+
+/** 发送一条请求并等待应答；reply 非空时接收 RTM_NEWLINK，否则等待 ACK。返回 0 或 errno */
+int Transact(LinkRequest& req, char* reply, size_t replyCap) {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0) return errno;
+
+    req.nh.nlmsg_seq = 1;
+    if (!reply) req.nh.nlmsg_flags |= NLM_F_ACK;
+
+    struct sockaddr_nl kernel {};
+    kernel.nl_family = AF_NETLINK;
+    if (sendto(fd, &req, req.nh.nlmsg_len, 0, reinterpret_cast<struct sockaddr*>(&kernel), sizeof(kernel)) < 0) {
+        int err = errno;
+        close(fd);
+        return err;
+    }
+
+    alignas(struct nlmsghdr) char buf[8192];
+    while (true) {
+        ssize_t len = recv(fd, buf, sizeof(buf), 0);
+        if (len < 0) {
+            if (errno == EINTR) continue;
+            int err = errno;
+            close(fd);
+            return err;
+        }
+        for (auto* nh = reinterpret_cast<struct nlmsghdr*>(buf); NLMSG_OK(nh, static_cast<unsigned int>(len));
+             nh = NLMSG_NEXT(nh, len)) {
+            if (nh->nlmsg_seq != req.nh.nlmsg_seq) continue;
+            if (nh->nlmsg_type == NLMSG_ERROR) {
+                auto* e = static_cast<struct nlmsgerr*>(NLMSG_DATA(nh));
+                close(fd);
+                return -e->error;
+            }
+            if (reply && nh->nlmsg_type == RTM_NEWLINK) {
+                if (nh->nlmsg_len > replyCap) {
+                    close(fd);
+                    return EMSGSIZE;
+                }
+                memcpy(reply, nh, nh->nlmsg_len);
+                close(fd);
+                return 0;
+            }
+        }
+    }
+}
+
+void ParseLinkInfo(struct rtattr* linkinfo, CanLinkInfo& info) {
+    int len = RTA_PAYLOAD(linkinfo);
+    for (auto* rta = static_cast<struct rtattr*>(RTA_DATA(linkinfo)); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+        if (rta->rta_type == IFLA_INFO_KIND) {
+            info.isCan = strcmp(static_cast<const char*>(RTA_DATA(rta)), "can") == 0;
+        } else if (rta->rta_type == IFLA_INFO_DATA) {
+            int dlen = RTA_PAYLOAD(rta);
+            for (auto* d = static_cast<struct rtattr*>(RTA_DATA(rta)); RTA_OK(d, dlen); d = RTA_NEXT(d, dlen)) {
+                if (d->rta_type == IFLA_CAN_BITTIMING && RTA_PAYLOAD(d) >= sizeof(struct can_bittiming)) {
+                    info.bitrate = static_cast<const struct can_bittiming*>(RTA_DATA(d))->bitrate;
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+bool CanLinkQuery(const std::string& ifname, CanLinkInfo& info, std::string& error) {
+    if (ifname.empty() || ifname.size() >= IFNAMSIZ) {
+        error = "接口名无效: " + ifname;
+        return false;
+    }
+
+    LinkRequest req;
+    InitRequest(req, RTM_GETLINK, 0, ifname);
+
+    alignas(struct nlmsghdr) char reply[8192];
+    int err = Transact(req, reply, sizeof(reply));
+    if (err) {
+        error = FormatError("查询接口", ifname, err);
+        return false;
+    }
+
+    info = CanLinkInfo();
+    auto* nh = reinterpret_cast<struct nlmsghdr*>(reply);
+    auto* ifi = static_cast<struct ifinfomsg*>(NLMSG_DATA(nh));
+    info.ifindex = ifi->ifi_index;
+    info.up = (ifi->ifi_flags & IFF_UP) != 0;
+
+    int len = static_cast<int>(nh->nlmsg_len - NLMSG_LENGTH(sizeof(*ifi)));
+    for (auto* rta = IFLA_RTA(ifi); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+        if (rta->rta_type == IFLA_TXQLEN && RTA_PAYLOAD(rta) >= sizeof(uint32_t)) {
+            memcpy(&info.txqlen, RTA_DATA(rta), sizeof(uint32_t));
+        } else if (rta->rta_type == IFLA_LINKINFO) {
+            ParseLinkInfo(rta, info);
+        }
+    }
+    return true;
+}
+
+bool CanLinkSetUp(const std::string& ifname, bool up, std::string& error) {
+    LinkRequest req;
+    InitRequest(req, RTM_NEWLINK, 0, ifname);
+    req.ifi.ifi_change = IFF_UP;
+    req.ifi.ifi_flags = up ? IFF_UP : 0;
+
+    int err = Transact(req, nullptr, 0);
+    if (err) {
+        error = FormatError(up ? "启动接口" : "关闭接口", ifname, err);
+        return false;
+    }
+    return true;
+}
+
+bool CanLinkConfigure(const std::string& ifname, uint32_t bitrate, CanLinkInfo& info, std::string& error) {
+    if (!CanLinkQuery(ifname, info, error)) return false;
+
+    bool setBitrate = info.isCan && info.bitrate != bitrate;
+    bool setTxqlen = info.txqlen < CAN_TXQUEUELEN;
+    if (info.up && !setBitrate && !setTxqlen) return true;
+
+    /* 位时序只能在接口关闭时修改 */
+    if (setBitrate && info.up && !CanLinkSetUp(ifname, false, error)) return false;
+
+    LinkRequest req;
+    InitRequest(req, RTM_NEWLINK, 0, ifname);
+    req.ifi.ifi_change = IFF_UP;
+    req.ifi.ifi_flags = IFF_UP;
+
+    if (setTxqlen) {
+        uint32_t txqlen = CAN_TXQUEUELEN;
+        AddAttr(&req.nh, IFLA_TXQLEN, &txqlen, sizeof(txqlen));
+    }
+    if (setBitrate) {
+        struct can_bittiming bt {};
+        bt.bitrate = bitrate;
+        struct rtattr* linkinfo = AddAttr(&req.nh, IFLA_LINKINFO, nullptr, 0);
+        AddAttr(&req.nh, IFLA_INFO_KIND, "can", 4);
+        struct rtattr* data = AddAttr(&req.nh, IFLA_INFO_DATA, nullptr, 0);
+        AddAttr(&req.nh, IFLA_CAN_BITTIMING, &bt, sizeof(bt));
+        EndNest(&req.nh, data);
+        EndNest(&req.nh, linkinfo);
+    }
+
+    int err = Transact(req, nullptr, 0);
+    if (err) {
+        error = FormatError(setBitrate ? "设置波特率" : "启动接口", ifname, err);
+        return false;
+    }
+
+    info.up = true;
+    if (setBitrate) info.bitrate = bitrate;
+    if (setTxqlen) info.txqlen = CAN_TXQUEUELEN;
+    return true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+#define CAN_TXQUEUELEN  64      /* 网卡发送队列下限，默认 10 帧容不下一个发送窗口 */
+
+/**
+ * 通过 rtnetlink 直接配置 CAN 接口，替代 system("ip link ...")。
+ * 失败时 error 给出具体原因（如缺少 CAP_NET_ADMIN、接口不存在）。
+ */
+struct CanLinkInfo {
+    int ifindex = 0;
+    bool up = false;
+    bool isCan = false;         /* IFLA_INFO_KIND 为 "can"（vcan 等虚拟接口没有位时序） */
+    uint32_t bitrate = 0;
+    uint32_t txqlen = 0;
+};
+
+bool CanLinkQuery(const std::string& ifname, CanLinkInfo& info, std::string& error);
+
+/**
+ * 设置波特率、发送队列长度并启动接口，info 返回配置后的状态。
+ * 接口已按相同配置启动时只查询一次；需要改波特率时先关闭接口。
+ */
+bool CanLinkConfigure(const std::string& ifname, uint32_t bitrate, CanLinkInfo& info, std::string& error);
+
+bool CanLinkSetUp(const std::string& ifname, bool up, std::string& error);
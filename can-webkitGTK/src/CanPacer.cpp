@@ -0,0 +1,110 @@
+#include "CanPacer.h"
+#include <algorithm>
+
+/* 数据帧 8 字节时约 111 位（不含位填充），见 CanFrameBits() */
+#define CAN_DATA_FRAME_BITS 111
+
+const char* CanBusStateName(CanBusState state) {
+    switch (state) {
+    case CanBusState::Active:  return "错误主动";
+    case CanBusState::Warning: return "错误警告";
+    case CanBusState::Passive: return "错误被动";
+    case CanBusState::BusOff:  return "总线关闭";
+    }
+    return "未知";
+}
+
+CanPacer::CanPacer(size_t maxWindow, int bitrate)
+    : m_maxWindow(maxWindow), m_window(maxWindow),
+      m_frameUs(bitrate > 0 ? CAN_DATA_FRAME_BITS * 1000000u / static_cast<uint32_t>(bitrate) : 111u) {
+    if (m_frameUs == 0) m_frameUs = 1;
+}
+
+CanBusState CanPacer::Classify(const struct can_frame& frame, CanBusState current) {
+    canid_t id = frame.can_id;
+    if (id & CAN_ERR_BUSOFF) return CanBusState::BusOff;
+
+    CanBusState state = current;
+    if (id & CAN_ERR_RESTARTED) state = CanBusState::Active;
+    if ((id & CAN_ERR_CRTL) && frame.can_dlc >= 2) {
+        uint8_t ctrl = frame.data[1];
+        if (ctrl & CAN_ERR_CRTL_ACTIVE) state = CanBusState::Active;
+        if (ctrl & (CAN_ERR_CRTL_RX_WARNING | CAN_ERR_CRTL_TX_WARNING)) state = CanBusState::Warning;
+        if (ctrl & (CAN_ERR_CRTL_RX_PASSIVE | CAN_ERR_CRTL_TX_PASSIVE)) state = CanBusState::Passive;
+    }
+    /* 驱动附带错误计数器时以计数器为准 */
+    if ((id & CAN_ERR_CNT) && frame.can_dlc >= 8 && current != CanBusState::BusOff) {
+        uint8_t counter = std::max(frame.data[6], frame.data[7]);
+        if (counter >= 128) state = CanBusState::Passive;
+        else if (counter >= 96) state = CanBusState::Warning;
+        else state = CanBusState::Active;
+    }
+    return state;
+}
+
+void CanPacer::Backoff(size_t window, uint32_t gapUs) {
+    window &= ~static_cast<size_t>(7);
+    m_window = std::min(m_window, std::max<size_t>(window, FW_PACE_MIN_WINDOW));
+    m_gapUs = std::min<uint32_t>(std::max(m_gapUs, gapUs), FW_GAP_MAX_US);
+    m_backoffs++;
+}
+
+void CanPacer::OnAck() {
+    if (m_clean && m_state == CanBusState::Active) {
+        m_window = std::min(m_window + 8, m_maxWindow);
+        m_gapUs -= m_gapUs / 4;
+        if (m_gapUs < 8) m_gapUs = 0;
+    }
+    m_clean = true;
+    m_congested = false;
+}
+
+void CanPacer::OnCongestion() {
+    /* 同一轮 ACK 之间的多次拥塞只退避一次，队列满时每次重试都会报 ENOBUFS */
+    if (m_congested) return;
+    m_congested = true;
+    m_clean = false;
+    Backoff(m_window / 2, std::max(m_gapUs * 2, m_frameUs));
+}
+
+void CanPacer::OnReceiverOverflow() {
+    if (m_congested) return;
+    m_congested = true;
+    m_clean = false;
+    Backoff(m_window / 2, m_gapUs);
+}
+
+bool CanPacer::OnErrorFrame(const struct can_frame& frame) {
+    m_errorFrames++;
+    m_clean = false;
+
+    CanBusState next = Classify(frame, m_state);
+    if (next == m_state) return false;
+    if (next == CanBusState::BusOff) {
+        Backoff(FW_PACE_MIN_WINDOW, FW_GAP_MAX_US);
+    } else if (next == CanBusState::Passive && m_state != CanBusState::BusOff) {
+        /* 错误被动节点每帧后多等 8 位，再让出至少 4 帧的时间给其他节点 */
+        Backoff(FW_PACE_MIN_WINDOW, std::max(m_gapUs * 2, m_frameUs * 4));
+    }
+    m_state = next;
+    return true;
+}
+
+size_t CanPacer::Allow(size_t want, int64_t nowNs) const {
+    if (m_gapUs == 0) return want;
+    if (nowNs < m_nextNs) return 0;
+    size_t n = 1 + static_cast<size_t>((nowNs - m_nextNs) / IntervalNs());
+    return std::min({n, want, static_cast<size_t>(FW_PACE_BURST)});
+}
+
+void CanPacer::OnSent(size_t frames, int64_t nowNs) {
+    /* 空闲期间最多积累一个突发的额度 */
+    int64_t interval = IntervalNs();
+    int64_t base = std::max(m_nextNs, nowNs - interval * (FW_PACE_BURST - 1));
+    m_nextNs = base + interval * static_cast<int64_t>(frames);
+}
+
+int CanPacer::DelayMs(int64_t nowNs) const {
+    if (m_gapUs == 0 || nowNs >= m_nextNs) return 0;
+    return static_cast<int>((m_nextNs - nowNs + 999999) / 1000000);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <linux/can.h>
+#include <linux/can/error.h>
+
+#ifndef CAN_ERR_CNT
+#define CAN_ERR_CNT         0x00000200U     /* 旧内核头文件缺少：data[6]/[7] 为 TX/RX 错误计数 */
+#endif
+
+#define FW_PACE_MIN_WINDOW  64      /* 窗口下限为一个 ACK 块，否则 bootloader 等不到回 OFFSET 的 64 字节 */
+#define FW_GAP_MAX_US       20000   /* 帧间隔上限，总线关闭后从此值开始恢复 */
+#define FW_PACE_BURST       8       /* 限速时单次最多连发的帧数 */
+
+/** 订阅的错误帧类别 (CAN_RAW_ERR_FILTER) */
+#define CAN_PACER_ERR_MASK  (CAN_ERR_CRTL | CAN_ERR_BUSOFF | CAN_ERR_RESTARTED | CAN_ERR_LOSTARB | \
+                             CAN_ERR_PROT | CAN_ERR_BUSERROR)
+
+/** 控制器错误状态，按 ISO 11898 错误计数器划分 */
+enum class CanBusState {
+    Active,     /* TEC/REC < 96 */
+    Warning,    /* >= 96 */
+    Passive,    /* >= 128，帧间需额外等待 8 位挂起时间 */
+    BusOff,     /* TEC > 255，控制器停止收发直到重启 */
+};
+
+const char* CanBusStateName(CanBusState state);
+
+/**
+ * 按总线状况调节发送节奏，类似拥塞控制的 AIMD：
+ * 干净的 ACK 让在途窗口加一帧、帧间隔缩小 1/4；ENOBUFS 让窗口减半、间隔翻倍，
+ * bootloader 溢出只让窗口减半；错误被动和总线关闭直接退到最小窗口和更大的间隔。
+ * 帧间隔由令牌桶实现，平均发送间隔为 帧时长 + gap。
+ */
+class CanPacer {
+public:
+    /** maxWindow: 窗口上限（字节）；bitrate 用于估算单帧时长 */
+    CanPacer(size_t maxWindow, int bitrate);
+
+    size_t Window() const { return m_window; }
+    uint32_t GapUs() const { return m_gapUs; }
+    CanBusState State() const { return m_state; }
+    size_t Backoffs() const { return m_backoffs; }
+    size_t ErrorFrames() const { return m_errorFrames; }
+
+    /** 每个 ACK 块确认一次；期间没有错误帧时才增大窗口、缩小间隔 */
+    void OnAck();
+    /** 网卡发送队列满 (ENOBUFS)：总线送不完，窗口减半、间隔翻倍 */
+    void OnCongestion();
+    /** bootloader 接收缓冲区溢出 (RX_OVERFLOW)：对端处理不过来，只收窄窗口 */
+    void OnReceiverOverflow();
+    /** 错误帧 (can_id 含 CAN_ERR_FLAG)，返回控制器状态是否变化 */
+    bool OnErrorFrame(const struct can_frame& frame);
+
+    /** nowNs 时刻允许发送的帧数，不超过 want；0 表示需等待 DelayMs() */
+    size_t Allow(size_t want, int64_t nowNs) const;
+    void OnSent(size_t frames, int64_t nowNs);
+    int DelayMs(int64_t nowNs) const;
+
+    /** 从错误帧解析控制器状态，不含状态信息时返回 current */
+    static CanBusState Classify(const struct can_frame& frame, CanBusState current);
+
+private:
+    void Backoff(size_t window, uint32_t gapUs);
+    int64_t IntervalNs() const { return (static_cast<int64_t>(m_frameUs) + m_gapUs) * 1000; }
+
+    size_t m_maxWindow;
+    size_t m_window;
+    uint32_t m_frameUs;
+    uint32_t m_gapUs = 0;
+    CanBusState m_state = CanBusState::Active;
+    bool m_clean = true;        /* 上次 ACK 以来没有错误帧和拥塞 */
+    bool m_congested = false;   /* 上次 ACK 以来已因拥塞退避过 */
+    int64_t m_nextNs = 0;       /* 下一帧最早发送时间 (CLOCK_MONOTONIC) */
+    size_t m_backoffs = 0;
+    size_t m_errorFrames = 0;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+
+#define PLATFORM_RX     0x101
+#define PLATFORM_TX     0x102
+#define FW_DATA_RX      0x103
+
+#define BOARD_START_UPDATE  0
+#define BOARD_CONFIRM       1
+#define BOARD_VERSION       2
+#define BOARD_REBOOT        3
+#define BOARD_RESUME        5
+
+#define FW_CODE_OFFSET          0
+#define FW_CODE_UPDATE_SUCCESS  1
+#define FW_CODE_VERSION         2
+#define FW_CODE_CONFIRM         3
+#define FW_CODE_FLASH_ERROR     4
+#define FW_CODE_TRANFER_ERROR   5
+#define FW_CODE_RX_OVERFLOW     7
+
+static inline void pack_u32(uint8_t* buf, uint32_t v1, uint32_t v2) {
+    buf[0] = (v1 >> 24) & 0xff; buf[1] = (v1 >> 16) & 0xff;
+    buf[2] = (v1 >> 8) & 0xff; buf[3] = v1 & 0xff;
+    buf[4] = (v2 >> 24) & 0xff; buf[5] = (v2 >> 16) & 0xff;
+    buf[6] = (v2 >> 8) & 0xff; buf[7] = v2 & 0xff;
+}
+
+static inline void unpack_u32(const uint8_t* buf, uint32_t* v1, uint32_t* v2) {
+    *v1 = (uint32_t(buf[0]) << 24) | (uint32_t(buf[1]) << 16) | (uint32_t(buf[2]) << 8) | uint32_t(buf[3]);
+    *v2 = (uint32_t(buf[4]) << 24) | (uint32_t(buf[5]) << 16) | (uint32_t(buf[6]) << 8) | uint32_t(buf[7]);
+}
@@ -0,0 +1,88 @@
+#include "CanReceiver.h"
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+int64_t CanRealtimeNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/* 取 SCM_TIMESTAMPING 中的软件接收时间戳 (ts[0], CLOCK_REALTIME)，没有则返回 0 */
+static int64_t rx_timestamp_ns(struct msghdr* msg) {
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(msg); cmsg; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPING) continue;
+        struct scm_timestamping tss;
+        memcpy(&tss, CMSG_DATA(cmsg), sizeof(tss));
+        if (tss.ts[0].tv_sec == 0 && tss.ts[0].tv_nsec == 0) return 0;
+        return static_cast<int64_t>(tss.ts[0].tv_sec) * 1000000000 + tss.ts[0].tv_nsec;
+    }
+    return 0;
+}
+
+bool CanPending::Match(const struct can_frame& frame) {
+    if (done || frame.can_id != canId || frame.can_dlc < 8) return false;
+
+    uint32_t c = 0, v = 0;
+    unpack_u32(frame.data, &c, &v);
+    if (c >= 32 || !(codes & CodeBit(c))) return false;
+    if ((c == FW_CODE_OFFSET || c == FW_CODE_UPDATE_SUCCESS) && (v < minOffset || v > maxOffset)) {
+        return false;
+    }
+
+    code = c;
+    val = v;
+    done = true;
+    return true;
+}
+
+CanReceiver::CanReceiver(int fd) : m_fd(fd) {
+    for (int i = 0; i < CAN_RX_BATCH; i++) {
+        m_iov[i].iov_base = &m_frames[i];
+        m_iov[i].iov_len = sizeof(struct can_frame);
+    }
+}
+
+int CanReceiver::Drain(const FrameHandler& onFrame) {
+    int total = 0;
+    while (true) {
+        /* 内核会改写 msg_controllen 和 msg_flags，每次调用前重置 */
+        memset(m_msgs, 0, sizeof(m_msgs));
+        for (int i = 0; i < CAN_RX_BATCH; i++) {
+            m_msgs[i].msg_hdr.msg_iov = &m_iov[i];
+            m_msgs[i].msg_hdr.msg_iovlen = 1;
+            m_msgs[i].msg_hdr.msg_control = m_control[i];
+            m_msgs[i].msg_hdr.msg_controllen = sizeof(m_control[i]);
+        }
+
+        int n = recvmmsg(m_fd, m_msgs, CAN_RX_BATCH, MSG_DONTWAIT, nullptr);
+        m_syscalls++;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return total;
+            return -1;
+        }
+
+        int64_t now = 0;
+        for (int i = 0; i < n; i++) {
+            /* 长度 0 表示面向连接的对端已关闭：CAN_RAW 不会出现，tests/test_can.cpp
+             * 中模拟 bootloader 的 socketpair 会；不当作断开处理会反复读到 EOF 而空转 */
+            if (m_msgs[i].msg_len == 0) {
+                errno = ECONNRESET;
+                return -1;
+            }
+            if (m_msgs[i].msg_len != sizeof(struct can_frame)) continue;
+            int64_t rxNs = rx_timestamp_ns(&m_msgs[i].msg_hdr);
+            if (rxNs == 0) {
+                if (now == 0) now = CanRealtimeNs();
+                rxNs = now;
+            }
+            onFrame(m_frames[i], rxNs);
+        }
+        total += n;
+
+        /* 未取满说明队列已空，省去一次必然 EAGAIN 的调用 */
+        if (n < CAN_RX_BATCH) return total;
+    }
+}
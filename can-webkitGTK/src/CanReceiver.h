@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <linux/can.h>
+#include <linux/errqueue.h>
+#include <sys/socket.h>
+
+#include "CanProtocol.h"
+
+#define CAN_RX_BATCH    32      /* 单次 recvmmsg 的最大帧数，大于 bootloader 一个窗口的 ACK 数 */
+
+/** 当前 CLOCK_REALTIME (ns)，与 SO_TIMESTAMPING 软件时间戳同一时钟 */
+int64_t CanRealtimeNs();
+
+/**
+ * 等待中的请求：按 CAN ID 与响应码匹配，OFFSET/UPDATE_SUCCESS 的偏移
+ * 不在 [minOffset, maxOffset] 内的视为过期 ACK 丢弃；错误码不检查偏移。
+ */
+struct CanPending {
+    uint32_t canId = PLATFORM_TX;
+    uint32_t codes = 0;             /* 接受的响应码位图，见 CodeBit() */
+    uint32_t minOffset = 0;
+    uint32_t maxOffset = UINT32_MAX;
+    bool done = false;
+    uint32_t code = 0;
+    uint32_t val = 0;
+
+    static constexpr uint32_t CodeBit(uint32_t code) { return 1u << code; }
+
+    CanPending() = default;
+    explicit CanPending(uint32_t codeMask) : codes(codeMask) {}
+
+    /** 帧匹配时保存响应并置完成，返回是否认领 */
+    bool Match(const struct can_frame& frame);
+};
+
+/**
+ * 批量接收：每次唤醒用 recvmmsg 取空 socket 接收队列，
+ * 同时取出每帧的内核接收时间戳（未开启 SO_TIMESTAMPING 时为取帧时刻）。
+ */
+class CanReceiver {
+public:
+    using FrameHandler = std::function<void(const struct can_frame& frame, int64_t rxNs)>;
+
+    explicit CanReceiver(int fd = -1);
+
+    void SetFd(int fd) { m_fd = fd; }
+
+    /** 非阻塞取出当前所有待收帧并逐帧回调，返回帧数，出错返回 -1 (errno) */
+    int Drain(const FrameHandler& onFrame);
+
+    size_t Syscalls() const { return m_syscalls; }
+
+private:
+    int m_fd;
+    size_t m_syscalls = 0;
+
+    struct can_frame m_frames[CAN_RX_BATCH];
+    struct iovec m_iov[CAN_RX_BATCH];
+    struct mmsghdr m_msgs[CAN_RX_BATCH];
+    alignas(struct cmsghdr) char m_control[CAN_RX_BATCH][CMSG_SPACE(sizeof(struct scm_timestamping))];
+};
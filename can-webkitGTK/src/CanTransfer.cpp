@@ -0,0 +1,301 @@
+#include "CanTransfer.h"
+#include "CanProtocol.h"
+#include "CanReceiver.h"
+#include "FirmwareImage.h"
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+using Clock = std::chrono::steady_clock;
+
+static int64_t monotonic_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+/* 读出并清除 socket 的挂起错误 (SO_ERROR)，没有时返回 ENETDOWN */
+static int take_socket_error(int fd) {
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err == 0) return ENETDOWN;
+    return err;
+}
+
+static size_t clamp_window(size_t window) {
+    if (window < FW_ACK_BLOCK) return FW_ACK_BLOCK;
+    if (window > FW_ACK_BLOCK * FW_RTT_SLOTS) return FW_ACK_BLOCK * FW_RTT_SLOTS;
+    return window;
+}
+
+CanTransfer::CanTransfer(int fd, const FirmwareImage& image, int bitrate, size_t window)
+    : m_fd(fd), m_rx(fd), m_size(image.Size()), m_frames(image.Frames()), m_frameCount(image.FrameCount()),
+      m_bitrate(bitrate), m_pacer(clamp_window(window), bitrate) {
+    m_stats.bytes = m_size;
+    m_start = m_lastAck = Clock::now();
+}
+
+bool CanTransfer::WantWrite() const {
+    if (m_done || m_failed) return false;
+    if (m_resumePending) return true;
+    return !m_resyncing && m_sent < m_size && m_sent - m_acked < m_pacer.Window();
+}
+
+int CanTransfer::ThrottleMs() const {
+    int ms = m_paced ? m_pacer.DelayMs(monotonic_ns()) : 1;
+    return ms < 1 ? 1 : ms;
+}
+
+void CanTransfer::OnSendError(int err) {
+    if (err == EAGAIN || err == EWOULDBLOCK) {
+        m_blocked = true;
+    } else if (err == ENOBUFS) {
+        /* 网卡发送队列满：socket 仍可写，EPOLLOUT 不会阻塞等待，由 Run() 短暂延时重试；
+         * 说明发得比总线能送出的快，同时收窄窗口、拉大帧间隔 */
+        m_noBufs = true;
+        m_pacer.OnCongestion();
+    } else {
+        Fail("发送 CAN 帧失败");
+    }
+}
+
+bool CanTransfer::WriteFrame(const struct can_frame& frame) {
+    while (true) {
+        ssize_t n = write(m_fd, &frame, sizeof(frame));
+        m_stats.syscalls++;
+        if (n == sizeof(frame)) {
+            m_stats.busBits += CanFrameBits(frame.can_dlc);
+            return true;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        OnSendError(n < 0 ? errno : EIO);
+        return false;
+    }
+}
+
+void CanTransfer::OnWritable() {
+    m_blocked = false;
+    m_noBufs = false;
+    m_paced = false;
+
+    if (m_resumePending && !m_failed) {
+        struct can_frame frame {};
+        frame.can_id = PLATFORM_RX;
+        frame.can_dlc = 8;
+        pack_u32(frame.data, BOARD_RESUME, static_cast<uint32_t>(m_acked));
+        if (!WriteFrame(frame)) return;
+        m_resumePending = false;
+    }
+
+    struct mmsghdr msgs[FW_BATCH_MAX];
+    struct iovec iov[FW_BATCH_MAX];
+
+    while (WantWrite()) {
+        /* 窗口剩余空间内的帧一次提交；m_sent 总是 8 的倍数（末帧除外） */
+        size_t first = m_sent / 8;
+        size_t count = (m_pacer.Window() - (m_sent - m_acked) + 7) / 8;
+        if (count > m_frameCount - first) count = m_frameCount - first;
+        if (count > FW_BATCH_MAX) count = FW_BATCH_MAX;
+        int64_t paceNs = monotonic_ns();
+        count = m_pacer.Allow(count, paceNs);
+        if (count == 0) {
+            m_paced = true;
+            return;
+        }
+
+        memset(msgs, 0, count * sizeof(msgs[0]));
+        for (size_t i = 0; i < count; i++) {
+            iov[i].iov_base = const_cast<struct can_frame*>(&m_frames[first + i]);
+            iov[i].iov_len = sizeof(struct can_frame);
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int n = sendmmsg(m_fd, msgs, static_cast<unsigned int>(count), MSG_DONTWAIT);
+        m_stats.syscalls++;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            OnSendError(errno);
+            return;
+        }
+        m_pacer.OnSent(static_cast<size_t>(n), paceNs);
+        /* 帧在 sendmmsg 返回时已进入网卡队列，以此作为 ACK 块的发送时间 */
+        int64_t now = CanRealtimeNs();
+        for (int i = 0; i < n; i++) {
+            const struct can_frame& frame = m_frames[first + i];
+            m_sent += frame.can_dlc;
+            m_stats.frames++;
+            m_stats.busBits += CanFrameBits(frame.can_dlc);
+            if (m_sent % FW_ACK_BLOCK == 0 || m_sent == m_size) {
+                size_t block = (m_sent + FW_ACK_BLOCK - 1) / FW_ACK_BLOCK;
+                m_txStamps[block % FW_RTT_SLOTS] = {block, now};
+            }
+        }
+    }
+}
+
+void CanTransfer::RecordRtt(size_t offset, int64_t rxNs) {
+    size_t block = (offset + FW_ACK_BLOCK - 1) / FW_ACK_BLOCK;
+    const TxStamp& tx = m_txStamps[block % FW_RTT_SLOTS];
+    if (tx.block != block || tx.ns == 0 || rxNs < tx.ns) return;
+    m_stats.rtt.Record(static_cast<uint64_t>((rxNs - tx.ns) / 1000));
+}
+
+void CanTransfer::OnFrame(const struct can_frame& frame, int64_t rxNs) {
+    if (m_done || m_failed) return;
+    if (frame.can_id & CAN_ERR_FLAG) {
+        m_pacer.OnErrorFrame(frame);
+        return;
+    }
+    if (frame.can_id != PLATFORM_TX || frame.can_dlc < 8) return;
+    m_stats.busBits += CanFrameBits(frame.can_dlc);
+
+    uint32_t code = 0, val = 0;
+    unpack_u32(frame.data, &code, &val);
+
+    switch (code) {
+    case FW_CODE_OFFSET:
+        if (val > m_sent) return;
+        if (m_resyncing) {
+            /* RESUME 的应答；之前在途的 OFFSET 不会超过溢出位置，直接忽略 */
+            if (val != m_acked) return;
+            m_resyncing = false;
+            m_lastAck = Clock::now();
+            return;
+        }
+        if (val <= m_acked) return;
+        m_acked = val;
+        m_stats.acks++;
+        m_pacer.OnAck();
+        RecordRtt(val, rxNs);
+        m_lastAck = Clock::now();
+        if (m_progressCb) m_progressCb(m_acked, m_size);
+        break;
+    case FW_CODE_UPDATE_SUCCESS:
+        if (val != m_size) {
+            Fail("升级完成响应的偏移与镜像大小不符");
+            return;
+        }
+        if (val > m_acked) RecordRtt(val, rxNs);
+        m_acked = val;
+        if (m_progressCb) m_progressCb(m_acked, m_size);
+        Finish();
+        break;
+    case FW_CODE_RX_OVERFLOW:
+        /* bootloader 接收缓冲区溢出：从其已接收位置重传 */
+        if (val > m_sent || val < m_acked || val % 8 != 0) {
+            Fail("RX_OVERFLOW 偏移无效");
+            return;
+        }
+        m_acked = val;
+        m_sent = val;
+        m_resyncing = true;
+        m_resumePending = true;
+        m_stats.resumes++;
+        m_pacer.OnReceiverOverflow();
+        m_lastAck = Clock::now();
+        break;
+    case FW_CODE_FLASH_ERROR:
+        Fail("Flash 写入错误");
+        break;
+    case FW_CODE_TRANFER_ERROR:
+        Fail("传输错误");
+        break;
+    default:
+        break;
+    }
+}
+
+int CanTransfer::CheckTimeout(int ackTimeoutMs) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - m_lastAck).count();
+    if (elapsed >= ackTimeoutMs) {
+        Fail("传输超时");
+        return 0;
+    }
+    return static_cast<int>(ackTimeoutMs - elapsed);
+}
+
+void CanTransfer::UpdateStats() {
+    m_stats.backoffs = m_pacer.Backoffs();
+    m_stats.errorFrames = m_pacer.ErrorFrames();
+    m_stats.seconds = std::chrono::duration<double>(Clock::now() - m_start).count();
+    if (m_stats.seconds > 0 && m_bitrate > 0) {
+        m_stats.busLoad = 100.0 * static_cast<double>(m_stats.busBits) / (m_bitrate * m_stats.seconds);
+    }
+}
+
+void CanTransfer::Fail(const char* error) {
+    m_failed = true;
+    m_error = error;
+    UpdateStats();
+}
+
+void CanTransfer::Finish() {
+    m_done = true;
+    UpdateStats();
+}
+
+bool CanTransfer::Run(int ackTimeoutMs) {
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    if (ep < 0) {
+        Fail("创建 epoll 失败");
+        return false;
+    }
+
+    struct epoll_event ev {};
+    ev.events = EPOLLIN;
+    ev.data.fd = m_fd;
+    if (epoll_ctl(ep, EPOLL_CTL_ADD, m_fd, &ev) < 0) {
+        close(ep);
+        Fail("epoll 注册失败");
+        return false;
+    }
+    uint32_t armed = EPOLLIN;
+
+    OnWritable();
+    while (!m_done && !m_failed) {
+        uint32_t want = EPOLLIN | (m_blocked ? EPOLLOUT : 0u);
+        if (want != armed) {
+            ev.events = want;
+            epoll_ctl(ep, EPOLL_CTL_MOD, m_fd, &ev);
+            armed = want;
+        }
+
+        int timeout = CheckTimeout(ackTimeoutMs);
+        if (m_failed) break;
+        if (Throttled() && timeout > ThrottleMs()) timeout = ThrottleMs();
+
+        struct epoll_event events[1];
+        int n = epoll_wait(ep, events, 1, timeout);
+        m_stats.syscalls++;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            Fail("epoll_wait 失败");
+            break;
+        }
+
+        if (n > 0 && (events[0].events & EPOLLIN)) {
+            size_t before = m_rx.Syscalls();
+            int frames = m_rx.Drain([this](const struct can_frame& frame, int64_t rxNs) {
+                OnFrame(frame, rxNs);
+            });
+            m_stats.syscalls += m_rx.Syscalls() - before;
+            if (frames < 0) {
+                m_sysError = errno;
+                Fail("接收 CAN 帧失败");
+                break;
+            }
+        }
+        /* 接口关闭或适配器拔出：错误不读走会一直报告，epoll_wait 将空转到超时 */
+        if (n > 0 && (events[0].events & (EPOLLERR | EPOLLHUP)) && !m_done) {
+            m_sysError = take_socket_error(m_fd);
+            Fail("CAN 接口错误");
+            break;
+        }
+
+        OnWritable();
+    }
+
+    close(ep);
+    return m_done;
+}
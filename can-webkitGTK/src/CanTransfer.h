@@ -0,0 +1,126 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <chrono>
+#include <functional>
+#include <linux/can.h>
+#include "CanPacer.h"
+#include "CanReceiver.h"
+#include "LatencyHistogram.h"
+
+class FirmwareImage;
+
+#define FW_ACK_BLOCK        64      /* bootloader 每收满 64 字节回一次 OFFSET */
+#define FW_WINDOW_DEFAULT   128     /* 未确认字节上限，不超过 bootloader 接收环形缓冲区 (16 帧) */
+#define FW_BATCH_MAX        64      /* 单次 sendmmsg 的最大帧数 */
+#define FW_RTT_SLOTS        64      /* 在途 ACK 块发送时间的环形表大小，覆盖 4 KB 窗口 */
+
+/** CAN 2.0A 数据帧位数（不含位填充）: SOF..IFS 共 47 位 + 数据 */
+static inline uint32_t CanFrameBits(uint8_t dlc) { return 47u + 8u * dlc; }
+
+struct TransferStats {
+    size_t bytes = 0;           /* 镜像大小 */
+    size_t frames = 0;          /* 发送的数据帧数（含重传） */
+    size_t acks = 0;            /* 收到的 OFFSET 响应数 */
+    size_t resumes = 0;         /* RX_OVERFLOW 后的重传次数 */
+    size_t backoffs = 0;        /* 拥塞或总线错误导致的降速次数 */
+    size_t errorFrames = 0;     /* 传输期间收到的 CAN 错误帧数 */
+    uint64_t busBits = 0;       /* 本次传输占用的总线位数（收发帧合计） */
+    size_t syscalls = 0;        /* sendmmsg/write/recvmmsg 与事件唤醒 (epoll_wait) 次数，含驱动方代收的部分 */
+    double seconds = 0;
+    double busLoad = 0;         /* busBits / (bitrate * seconds) * 100 */
+    LatencyHistogram rtt;       /* 每个 ACK 块从发出末帧到收到 OFFSET 的往返时延 (us) */
+};
+
+/**
+ * 固件数据窗口发送器：非阻塞 socket 上保持最多 window 字节未确认，
+ * 收到 OFFSET 即推进窗口，窗口有空间时从不空等。
+ * 数据帧取自 FirmwareImage 预生成的帧表，窗口内的空闲部分由一次 sendmmsg 批量提交。
+ * 在途窗口和帧间隔由 CanPacer 按 ENOBUFS、bootloader 溢出和总线错误帧调节。
+ * 由事件驱动：CanManager 在共享事件循环中调用 OnWritable() / OnFrame()，
+ * 收帧和唤醒的系统调用由其通过 AddSyscalls() 计入统计；
+ * Run() 为不依赖事件循环的单接口 epoll 循环（自带 recvmmsg 接收），供 tests/test_can.cpp 使用。
+ */
+class CanTransfer {
+public:
+    using ProgressCallback = std::function<void(size_t acked, size_t total)>;
+
+    /** image 须在传输期间保持有效 */
+    CanTransfer(int fd, const FirmwareImage& image, int bitrate,
+                size_t window = FW_WINDOW_DEFAULT);
+
+    void SetProgressCallback(ProgressCallback cb) { m_progressCb = std::move(cb); }
+
+    /** 单接口 epoll 循环，ackTimeoutMs 内窗口无推进视为超时 */
+    bool Run(int ackTimeoutMs);
+
+    /** 批量发送窗口内的帧，直到窗口满、内核队列满 (EAGAIN/ENOBUFS) 或限速 */
+    void OnWritable();
+    /** rxNs 为接收时间 (CLOCK_REALTIME ns)，优先取内核 SO_TIMESTAMPING 时间戳；也接收错误帧 */
+    void OnFrame(const struct can_frame& frame, int64_t rxNs);
+
+    /** 驱动方代为执行的系统调用（recvmmsg、epoll_wait 唤醒）计入 Stats().syscalls */
+    void AddSyscalls(size_t n) { m_stats.syscalls += n; }
+
+    /** 外部终止（如接口断开），已结束时无效 */
+    void Abort(const char* error) {
+        if (!m_done && !m_failed) Fail(error);
+    }
+
+    bool WantWrite() const;
+    bool Blocked() const { return m_blocked; }
+    /** ENOBUFS 或帧间隔限速：socket 可写但需定时重试，间隔见 ThrottleMs() */
+    bool Throttled() const { return m_noBufs || m_paced; }
+    int ThrottleMs() const;
+    const CanPacer& Pacer() const { return m_pacer; }
+    /** 距上次窗口推进已超过 ackTimeoutMs 时置失败，返回剩余毫秒数 */
+    int CheckTimeout(int ackTimeoutMs);
+    bool Done() const { return m_done; }
+    bool Failed() const { return m_failed; }
+    const char* Error() const { return m_error; }
+    /** 接收失败或接口错误时的 errno，其余失败为 0 */
+    int SysError() const { return m_sysError; }
+    size_t Acked() const { return m_acked; }
+    const TransferStats& Stats() const { return m_stats; }
+
+private:
+    bool WriteFrame(const struct can_frame& frame);
+    void OnSendError(int err);
+    void RecordRtt(size_t offset, int64_t rxNs);
+    void UpdateStats();
+    void Fail(const char* error);
+    void Finish();
+
+    int m_fd;
+    CanReceiver m_rx;           /* 仅 Run() 使用 */
+    size_t m_size;
+    const struct can_frame* m_frames;   /* 第 i 帧对应偏移 i*8 */
+    size_t m_frameCount;
+    int m_bitrate;
+    CanPacer m_pacer;           /* 在途窗口上限为构造时的 window */
+
+    size_t m_sent = 0;          /* 下一帧的偏移 */
+    size_t m_acked = 0;         /* bootloader 确认的偏移 */
+    bool m_blocked = false;     /* 上次写入返回 EAGAIN，等待 EPOLLOUT */
+    bool m_noBufs = false;      /* 上次写入返回 ENOBUFS，短暂延时后重试 */
+    bool m_paced = false;       /* 帧间隔未到，等待 ThrottleMs() */
+    bool m_resumePending = false;
+    bool m_resyncing = false;   /* 已发 RESUME，等待 OFFSET(m_acked) */
+    bool m_done = false;
+    bool m_failed = false;
+    const char* m_error = "";
+    int m_sysError = 0;
+
+    /* 以 ACK 块号 (结束偏移向上取整到 64) 为键；重传时覆盖为新的发送时间 */
+    struct TxStamp {
+        size_t block = 0;
+        int64_t ns = 0;
+    };
+    TxStamp m_txStamps[FW_RTT_SLOTS];
+
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_lastAck;
+    TransferStats m_stats;
+    ProgressCallback m_progressCb;
+};
@@ -0,0 +1,67 @@
+#include "FirmwareImage.h"
+#include "CanProtocol.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+FirmwareImage::~FirmwareImage() {
+    Close();
+}
+
+void FirmwareImage::Close() {
+    if (m_data) {
+        munmap(m_data, m_size);
+        m_data = nullptr;
+    }
+    m_size = 0;
+    m_frames.clear();
+}
+
+bool FirmwareImage::Open(const std::string& path, std::string& error) {
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "无法打开文件: " + path + " (" + strerror(errno) + ")";
+        return false;
+    }
+
+    struct stat st {};
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        error = "不是普通文件: " + path;
+        return false;
+    }
+    /* 协议中镜像大小为 32 位 */
+    if (st.st_size <= 0 || static_cast<uint64_t>(st.st_size) > UINT32_MAX) {
+        close(fd);
+        error = "固件大小无效: " + std::to_string(static_cast<long long>(st.st_size)) + " 字节";
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        error = "映射文件失败: " + path + " (" + strerror(errno) + ")";
+        return false;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+
+    m_data = static_cast<uint8_t*>(map);
+    m_size = size;
+
+    m_frames.resize((size + 7) / 8);
+    for (size_t i = 0; i < m_frames.size(); i++) {
+        size_t len = (size - i * 8 < 8) ? size - i * 8 : 8;
+        struct can_frame& frame = m_frames[i];
+        memset(&frame, 0, sizeof(frame));
+        frame.can_id = FW_DATA_RX;
+        frame.can_dlc = static_cast<uint8_t>(len);
+        memcpy(frame.data, m_data + i * 8, len);
+    }
+    return true;
+}
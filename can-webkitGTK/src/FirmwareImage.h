@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <linux/can.h>
+
+/**
+ * 只读映射的固件镜像：打开时 mmap 并校验一次，同时生成全部数据帧。
+ * 第 i 帧对应偏移 i*8，重传和多目标会话直接复用同一组帧，不再读文件或拷贝。
+ */
+class FirmwareImage {
+public:
+    FirmwareImage() = default;
+    ~FirmwareImage();
+
+    FirmwareImage(const FirmwareImage&) = delete;
+    FirmwareImage& operator=(const FirmwareImage&) = delete;
+
+    /** 失败时返回 false，error 为可直接显示的原因 */
+    bool Open(const std::string& path, std::string& error);
+    void Close();
+
+    const uint8_t* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+    const struct can_frame* Frames() const { return m_frames.data(); }
+    size_t FrameCount() const { return m_frames.size(); }
+
+private:
+    uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    std::vector<struct can_frame> m_frames;
+};
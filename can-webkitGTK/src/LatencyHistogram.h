@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <array>
+
+/**
+ * HDR 风格的对数-线性直方图（单位微秒）：32 以下逐值计数，
+ * 之上每个 2 的幂区间再分 32 个子桶，相对误差不超过约 3%，上限约 67 s。
+ * 固定 2.8 KB，记录为 O(1)，适合每个 ACK 都记录一次。
+ */
+class LatencyHistogram {
+public:
+    void Record(uint64_t us) {
+        if (us > kMaxValue) us = kMaxValue;
+        m_counts[BucketIndex(us)]++;
+        if (m_count == 0 || us < m_min) m_min = us;
+        if (us > m_max) m_max = us;
+        m_count++;
+        m_sum += us;
+    }
+
+    void Reset() { *this = LatencyHistogram(); }
+
+    uint64_t Count() const { return m_count; }
+    uint64_t Min() const { return m_min; }
+    uint64_t Max() const { return m_max; }
+    double Mean() const { return m_count ? static_cast<double>(m_sum) / m_count : 0.0; }
+
+    /** p 为百分位 (0~100)，返回所在桶的上界，不超过实际最大值 */
+    uint64_t Percentile(double p) const {
+        if (m_count == 0) return 0;
+        uint64_t target = static_cast<uint64_t>(p / 100.0 * m_count + 0.5);
+        if (target < 1) target = 1;
+        if (target > m_count) target = m_count;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < m_counts.size(); i++) {
+            seen += m_counts[i];
+            if (seen >= target) {
+                uint64_t upper = BucketUpper(i);
+                return upper < m_max ? upper : m_max;
+            }
+        }
+        return m_max;
+    }
+
+private:
+    static constexpr int kSubBits = 5;
+    static constexpr int kMaxExp = 26;
+    static constexpr uint64_t kMaxValue = (uint64_t(1) << kMaxExp) - 1;
+    static constexpr size_t kBuckets = size_t(kMaxExp - kSubBits + 1) << kSubBits;
+
+    static size_t BucketIndex(uint64_t v) {
+        if (v < (1u << kSubBits)) return static_cast<size_t>(v);
+        int e = 63 - __builtin_clzll(v);
+        size_t sub = static_cast<size_t>(v >> (e - kSubBits)) & ((1u << kSubBits) - 1);
+        return (static_cast<size_t>(e - kSubBits + 1) << kSubBits) + sub;
+    }
+
+    static uint64_t BucketUpper(size_t idx) {
+        if (idx < (1u << kSubBits)) return idx;
+        int e = static_cast<int>(idx >> kSubBits) + kSubBits - 1;
+        uint64_t sub = idx & ((1u << kSubBits) - 1);
+        uint64_t lower = ((uint64_t(1) << kSubBits) + sub) << (e - kSubBits);
+        return lower + (uint64_t(1) << (e - kSubBits)) - 1;
+    }
+
+    std::array<uint32_t, kBuckets> m_counts{};
+    uint64_t m_count = 0;
+    uint64_t m_sum = 0;
+    uint64_t m_min = 0;
+    uint64_t m_max = 0;
+};
@@ -0,0 +1,83 @@
+#include "SessionManager.h"
+#include "FirmwareImage.h"
+#include <cstdio>
+
+SessionManager::SessionManager(CanEventLoop& loop) : m_loop(loop) {}
+
+SessionManager::~SessionManager() {
+    Close();
+}
+
+void SessionManager::Log(size_t channel, const char* msg) {
+    if (m_logCb) m_logCb(channel, msg);
+}
+
+size_t SessionManager::Open(const std::vector<std::string>& interfaces, int baudrateIndex) {
+    Close();
+
+    size_t connected = 0;
+    m_channels.resize(interfaces.size());
+    for (size_t i = 0; i < interfaces.size(); i++) {
+        Channel& ch = m_channels[i];
+        ch.interface = interfaces[i];
+        ch.mgr = std::make_unique<CanManager>(m_loop);
+        ch.mgr->SetLogCallback([this, i](const char* msg) { Log(i, msg); });
+        ch.mgr->SetProgressCallback([this, i](int percent) {
+            if (m_progressCb) m_progressCb(i, percent);
+        });
+        ch.connected = ch.mgr->Connect(ch.interface, baudrateIndex);
+        if (ch.connected) connected++;
+    }
+    return connected;
+}
+
+void SessionManager::Close() {
+    for (Channel& ch : m_channels) {
+        if (ch.mgr) ch.mgr->Disconnect();
+    }
+    m_channels.clear();
+}
+
+Detached SessionManager::RunChannel(size_t channel, const FirmwareImage& image, bool testMode,
+                                    ChannelResult& result) {
+    CanManager& mgr = *m_channels[channel].mgr;
+    result.success = co_await mgr.Upgrade(image, testMode);
+    result.stats = mgr.LastTransferStats();
+
+    /* 最后一路结束后由事件循环恢复等待者：等待者可能随即销毁本会话，
+     * 不能在 CanManager 的回调栈内进行 */
+    if (--m_running == 0 && m_allDone) {
+        m_loop.AddTimer(0, [h = std::exchange(m_allDone, {})]() { h.resume(); });
+    }
+}
+
+Task<std::vector<ChannelResult>> SessionManager::UpgradeAll(std::string fileName, bool testMode) {
+    std::vector<ChannelResult> results(m_channels.size());
+    for (size_t i = 0; i < m_channels.size(); i++) {
+        results[i].interface = m_channels[i].interface;
+        results[i].connected = m_channels[i].connected;
+    }
+
+    /* 镜像只映射一次，各路 CanTransfer 直接引用同一份帧表 */
+    FirmwareImage image;
+    std::string error;
+    if (!image.Open(fileName, error)) {
+        Log(ALL_CHANNELS, error.c_str());
+        co_return results;
+    }
+
+    m_running = 0;
+    for (const Channel& ch : m_channels) {
+        if (ch.connected) m_running++;
+    }
+    char msg[96];
+    snprintf(msg, sizeof(msg), "固件大小: %zu 字节, %zu 路同时升级", image.Size(), m_running);
+    Log(ALL_CHANNELS, msg);
+
+    /* 各路协程立即开始，在第一个 co_await 处挂起后轮到下一路 */
+    for (size_t i = 0; i < m_channels.size(); i++) {
+        if (m_channels[i].connected) RunChannel(i, image, testMode, results[i]);
+    }
+    co_await AllDoneAwaiter{*this};
+    co_return results;
+}
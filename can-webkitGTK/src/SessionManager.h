@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <coroutine>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CanEventLoop.h"
+#include "CanManager.h"
+#include "CanTransfer.h"
+#include "Task.h"
+
+class FirmwareImage;
+
+struct ChannelResult {
+    std::string interface;
+    bool connected = false;
+    bool success = false;
+    TransferStats stats;
+};
+
+/**
+ * 多接口并行升级：每个接口一个 CanManager，共用同一个事件循环和同一份镜像帧表。
+ * 各路传输在一个线程内交错推进，总耗时约等于最慢的一路，而不是各路之和。
+ */
+class SessionManager {
+public:
+    static constexpr size_t ALL_CHANNELS = SIZE_MAX;   /* 日志回调中表示会话级消息 */
+
+    using LogCallback = std::function<void(size_t channel, const char* msg)>;
+    using ProgressCallback = std::function<void(size_t channel, int percent)>;
+
+    explicit SessionManager(CanEventLoop& loop);
+    ~SessionManager();
+
+    SessionManager(const SessionManager&) = delete;
+    SessionManager& operator=(const SessionManager&) = delete;
+
+    void SetLogCallback(LogCallback cb) { m_logCb = std::move(cb); }
+    void SetProgressCallback(ProgressCallback cb) { m_progressCb = std::move(cb); }
+
+    /** 逐个连接接口，返回连接成功的个数；失败的接口在结果中标记为未连接 */
+    size_t Open(const std::vector<std::string>& interfaces, int baudrateIndex);
+    void Close();
+
+    size_t Count() const { return m_channels.size(); }
+    const std::string& Interface(size_t channel) const { return m_channels[channel].interface; }
+    bool Connected(size_t channel) const { return m_channels[channel].connected; }
+
+    /** 所有已连接接口同时升级，全部结束后返回各路结果 */
+    Task<std::vector<ChannelResult>> UpgradeAll(std::string fileName, bool testMode);
+
+private:
+    struct Channel {
+        std::string interface;
+        std::unique_ptr<CanManager> mgr;
+        bool connected = false;
+    };
+
+    /** co_await 直到 m_running 归零 */
+    struct AllDoneAwaiter {
+        SessionManager& session;
+        bool await_ready() const noexcept { return session.m_running == 0; }
+        void await_suspend(std::coroutine_handle<> h) noexcept { session.m_allDone = h; }
+        void await_resume() const noexcept {}
+    };
+
+    Detached RunChannel(size_t channel, const FirmwareImage& image, bool testMode, ChannelResult& result);
+    void Log(size_t channel, const char* msg);
+
+    CanEventLoop& m_loop;
+    std::vector<Channel> m_channels;
+    size_t m_running = 0;
+    std::coroutine_handle<> m_allDone;
+    LogCallback m_logCb;
+    ProgressCallback m_progressCb;
+};
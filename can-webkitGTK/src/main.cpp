@@ -1,24 +1,37 @@
+#include "CanEventLoop.h"
 #include "CanManager.h"
+#include "SessionManager.h"
 #include "index_html.h"
 
 #include <gtk/gtk.h>
+#include <glib-unix.h>
 #include <webkit/webkit.h>
 
+#include <atomic>
 #include <cstdio>
 #include <cstring>
 #include <string>
 #include <memory>
-#include <thread>
-#include <atomic>
+
+#define UI_TICK_MS      33      /* 页面消息合并周期，约 30 帧/秒 */
 
 struct AppState {
     GtkApplication *app = nullptr;
     GtkWindow *window = nullptr;
     WebKitWebView *webview = nullptr;
+    std::unique_ptr<CanEventLoop> loop;    /* CAN 事件循环，由 GLib 主循环驱动 */
     std::unique_ptr<CanManager> canMgr;
     bool isConnected = false;
-    std::atomic<bool> isUpdating{false};
+    bool isUpdating = false;
     std::vector<std::string> channels;
+
+    /* 发往页面的消息：进度只写原子槽位，日志和事件排队，由 UI 定时器每帧合并成一次脚本调用 */
+    std::vector<std::atomic<int>> progress;
+    std::vector<int> progressSent;
+    bool progressPerChannel = false;
+    std::vector<std::string> pendingLogs;
+    std::vector<std::string> pendingEvents;
+    guint uiTimer = 0;
 };
 
 static AppState g_app;
@@ -39,12 +52,76 @@ static std::string JsonEscape(const char* str) {
     return result;
 }
 
+/* 把变化的进度和已排队的日志转成事件，保持与其后事件的先后顺序 */
+static void CollectPending() {
+    for (size_t i = 0; i < g_app.progress.size(); i++) {
+        int percent = g_app.progress[i].load(std::memory_order_relaxed);
+        if (percent == g_app.progressSent[i]) continue;
+        g_app.progressSent[i] = percent;
+        char json[80];
+        if (g_app.progressPerChannel) {
+            snprintf(json, sizeof(json), "{\"event\":\"progress\",\"channel\":%zu,\"percent\":%d}", i, percent);
+        } else {
+            snprintf(json, sizeof(json), "{\"event\":\"progress\",\"percent\":%d}", percent);
+        }
+        g_app.pendingEvents.push_back(json);
+    }
+
+    if (!g_app.pendingLogs.empty()) {
+        std::string json = "{\"event\":\"log\",\"messages\":[";
+        for (size_t i = 0; i < g_app.pendingLogs.size(); i++) {
+            if (i > 0) json += ",";
+            json += "\"" + g_app.pendingLogs[i] + "\"";
+        }
+        json += "]}";
+        g_app.pendingLogs.clear();
+        g_app.pendingEvents.push_back(std::move(json));
+    }
+}
+
+static gboolean on_ui_tick(gpointer) {
+    CollectPending();
+    if (g_app.pendingEvents.empty()) {
+        /* 空闲时停掉定时器，有新消息时再启动 */
+        g_app.uiTimer = 0;
+        return G_SOURCE_REMOVE;
+    }
+
+    if (g_app.webview) {
+        std::string js = "if(window._onBridgeBatch)window._onBridgeBatch([";
+        for (size_t i = 0; i < g_app.pendingEvents.size(); i++) {
+            if (i > 0) js += ",";
+            js += g_app.pendingEvents[i];
+        }
+        js += "])";
+        webkit_web_view_evaluate_javascript(g_app.webview, js.c_str(), -1, nullptr, nullptr, nullptr, nullptr, nullptr);
+    }
+    g_app.pendingEvents.clear();
+    return G_SOURCE_CONTINUE;
+}
+
+static void ScheduleUiTick() {
+    if (g_app.uiTimer == 0) g_app.uiTimer = g_timeout_add(UI_TICK_MS, on_ui_tick, nullptr);
+}
+
 static void PostJson(const char* json) {
-    if (!g_app.webview) return;
-    std::string js = "if(window._onBridgeMessage)window._onBridgeMessage({data:";
-    js += json;
-    js += "})";
-    webkit_web_view_evaluate_javascript(g_app.webview, js.c_str(), -1, nullptr, nullptr, nullptr, nullptr, nullptr);
+    CollectPending();
+    g_app.pendingEvents.push_back(json);
+    ScheduleUiTick();
+}
+
+/* 新一轮升级前重置进度槽位，perChannel 为 true 时按通道上报 */
+static void ResetProgress(size_t slots, bool perChannel) {
+    CollectPending();
+    g_app.progress = std::vector<std::atomic<int>>(slots);
+    g_app.progressSent.assign(slots, 0);
+    g_app.progressPerChannel = perChannel;
+}
+
+static void SetProgress(size_t slot, int percent) {
+    if (slot >= g_app.progress.size()) return;
+    g_app.progress[slot].store(percent, std::memory_order_relaxed);
+    ScheduleUiTick();
 }
 
 static std::string GetJsonString(const char* json, const char* key) {
@@ -99,27 +176,13 @@ static bool GetJsonBool(const char* json, const char* key) {
     return *pos == 't';
 }
 
-static gboolean idle_post_json(gpointer data) {
-    char* json = static_cast<char*>(data);
-    PostJson(json);
-    g_free(json);
-    return G_SOURCE_REMOVE;
-}
-
-static void PostJsonFromThread(const char* json) {
-    g_idle_add(idle_post_json, g_strdup(json));
-}
-
 static void OnLogMessage(const char* msg) {
-    std::string escaped = JsonEscape(msg);
-    std::string json = "{\"event\":\"log\",\"message\":\"" + escaped + "\"}";
-    PostJsonFromThread(json.c_str());
+    g_app.pendingLogs.push_back(JsonEscape(msg));
+    ScheduleUiTick();
 }
 
 static void OnProgress(int percent) {
-    char json[64];
-    snprintf(json, sizeof(json), "{\"event\":\"progress\",\"percent\":%d}", percent);
-    PostJsonFromThread(json);
+    SetProgress(0, percent);
 }
 
 static void HandleRefreshDevices() {
@@ -183,8 +246,8 @@ static void HandleBrowseFile() {
     g_object_unref(dialog);
 }
 
-static void HandleGetVersion() {
-    uint32_t ver = g_app.canMgr->GetFirmwareVersion();
+static Detached HandleGetVersion() {
+    uint32_t ver = co_await g_app.canMgr->Version();
     if (ver) {
         char buf[64];
         snprintf(buf, sizeof(buf), "v%u.%u.%u", (ver >> 24) & 0xFF, (ver >> 16) & 0xFF, (ver >> 8) & 0xFF);
@@ -199,20 +262,87 @@ static void HandleReboot() {
     }
 }
 
-static void HandleFlash(const std::string& path, bool testMode) {
-    if (g_app.isUpdating || !g_app.isConnected) return;
+static Detached HandleFlash(std::string path, bool testMode) {
+    if (g_app.isUpdating || !g_app.isConnected) co_return;
     g_app.isUpdating = true;
     g_app.canMgr->SetLogCallback(OnLogMessage);
+    g_app.canMgr->SetProgressCallback(OnProgress);
+    ResetProgress(1, false);
     PostJson("{\"event\":\"flashStart\"}");
 
-    std::thread([path, testMode]() {
-        g_app.canMgr->SetProgressCallback(OnProgress);
-        bool ok = g_app.canMgr->FirmwareUpgrade(path, testMode);
-        char json[64];
-        snprintf(json, sizeof(json), "{\"event\":\"flashComplete\",\"success\":%s}", ok ? "true" : "false");
-        PostJsonFromThread(json);
-        g_app.isUpdating = false;
-    }).detach();
+    bool ok = co_await g_app.canMgr->Upgrade(path, testMode);
+    const TransferStats& st = g_app.canMgr->LastTransferStats();
+    char json[320];
+    snprintf(json, sizeof(json),
+             "{\"event\":\"flashComplete\",\"success\":%s,\"stats\":{"
+             "\"seconds\":%.3f,\"busLoad\":%.1f,\"resumes\":%zu,\"rttCount\":%llu,"
+             "\"rttP50Us\":%llu,\"rttP99Us\":%llu,\"rttMaxUs\":%llu}}",
+             ok ? "true" : "false", st.seconds, st.busLoad, st.resumes,
+             static_cast<unsigned long long>(st.rtt.Count()),
+             static_cast<unsigned long long>(st.rtt.Percentile(50)),
+             static_cast<unsigned long long>(st.rtt.Percentile(99)),
+             static_cast<unsigned long long>(st.rtt.Max()));
+    PostJson(json);
+    g_app.isUpdating = false;
+}
+
+/* 所有接口同时升级：临时会话，结束后逐个断开 */
+static Detached HandleFlashAll(std::string path, bool testMode, int baudIndex) {
+    if (g_app.isUpdating || g_app.isConnected || g_app.channels.empty() || baudIndex < 0 || baudIndex >= 8) {
+        co_return;
+    }
+    g_app.isUpdating = true;
+
+    SessionManager session(*g_app.loop);
+    session.SetLogCallback([&session](size_t channel, const char* msg) {
+        if (channel == SessionManager::ALL_CHANNELS) {
+            OnLogMessage(msg);
+            return;
+        }
+        std::string line = "[" + session.Interface(channel) + "] " + msg;
+        OnLogMessage(line.c_str());
+    });
+    session.SetProgressCallback(SetProgress);
+
+    /* 连接后再通知页面，未连接的接口不计入总进度 */
+    size_t opened = session.Open(g_app.channels, baudIndex);
+    std::string json = "{\"event\":\"flashStart\",\"channels\":[";
+    for (size_t i = 0; i < session.Count(); i++) {
+        if (i > 0) json += ",";
+        json += "\"" + JsonEscape(session.Interface(i).c_str()) + "\"";
+    }
+    json += "],\"connected\":[";
+    for (size_t i = 0; i < session.Count(); i++) {
+        if (i > 0) json += ",";
+        json += session.Connected(i) ? "true" : "false";
+    }
+    json += "]}";
+    ResetProgress(session.Count(), true);
+    PostJson(json.c_str());
+
+    std::vector<ChannelResult> results;
+    if (opened > 0) {
+        results = co_await session.UpgradeAll(path, testMode);
+    } else {
+        OnLogMessage("没有可用的 CAN 接口");
+    }
+    session.Close();
+
+    bool allOk = !results.empty();
+    json = "{\"event\":\"flashComplete\",\"results\":[";
+    for (size_t i = 0; i < results.size(); i++) {
+        const ChannelResult& r = results[i];
+        if (r.connected && !r.success) allOk = false;
+        char item[64];
+        snprintf(item, sizeof(item), "\",\"connected\":%s,\"success\":%s,\"seconds\":%.3f}",
+                 r.connected ? "true" : "false", r.success ? "true" : "false", r.stats.seconds);
+        if (i > 0) json += ",";
+        json += "{\"name\":\"" + JsonEscape(r.interface.c_str()) + item;
+    }
+    json += "],\"success\":";
+    json += allOk ? "true}" : "false}";
+    PostJson(json.c_str());
+    g_app.isUpdating = false;
 }
 
 static void on_script_message(WebKitUserContentManager*, JSCValue* value, gpointer) {
@@ -236,7 +366,11 @@ static void on_script_message(WebKitUserContentManager*, JSCValue* value, gpoint
         HandleReboot();
     } else if (action == "flash") {
         std::string path = GetJsonString(msg, "path");
-        HandleFlash(path, GetJsonBool(msg, "testMode"));
+        if (GetJsonBool(msg, "allChannels")) {
+            HandleFlashAll(path, GetJsonBool(msg, "testMode"), GetJsonInt(msg, "baudIndex"));
+        } else {
+            HandleFlash(path, GetJsonBool(msg, "testMode"));
+        }
     }
 
     g_free(msg);
@@ -309,12 +443,32 @@ static void on_activate(GtkApplication* app, gpointer) {
     gtk_window_present(GTK_WINDOW(window));
 }
 
+static gboolean on_can_events(gint, GIOCondition, gpointer) {
+    g_app.loop->Dispatch(0);
+    return G_SOURCE_CONTINUE;
+}
+
 int main(int argc, char* argv[]) {
-    g_app.canMgr = std::make_unique<CanManager>();
+    g_app.loop = std::make_unique<CanEventLoop>();
+    if (!g_app.loop->Valid()) {
+        fprintf(stderr, "创建事件循环失败\n");
+        return 1;
+    }
+    g_app.canMgr = std::make_unique<CanManager>(*g_app.loop);
+    g_app.canMgr->SetDisconnectCallback([]() {
+        g_app.isConnected = false;
+        PostJson("{\"event\":\"connectResult\",\"success\":false}");
+    });
+    guint canSource = g_unix_fd_add(g_app.loop->Fd(), G_IO_IN, on_can_events, nullptr);
 
     GtkApplication* app = gtk_application_new("com.can.upgrade", G_APPLICATION_DEFAULT_FLAGS);
     g_signal_connect(app, "activate", G_CALLBACK(on_activate), nullptr);
     int status = g_application_run(G_APPLICATION(app), argc, argv);
     g_object_unref(app);
+
+    if (g_app.uiTimer) g_source_remove(g_app.uiTimer);
+    g_source_remove(canSource);
+    g_app.canMgr.reset();
+    g_app.loop.reset();
     return status;
 }
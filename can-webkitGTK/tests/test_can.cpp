@@ -0,0 +1,346 @@
+/**
+ * @file test_can.cpp
+ * @brief CAN 升级引擎测试程序
+ *
+ * 纯逻辑：CanPending 响应匹配、LatencyHistogram 分桶与百分位、CanPacer 的 AIMD 调节；
+ * 收发路径：CanReceiver 与 CanTransfer::Run() 通过 socketpair 对接模拟的 bootloader
+ * （每 64 字节回 OFFSET，可模拟接收溢出和中途断开），不需要 CAN 设备。
+ *
+ * @date 2026-10-18
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "CanPacer.h"
+#include "CanProtocol.h"
+#include "CanReceiver.h"
+#include "CanTransfer.h"
+#include "FirmwareImage.h"
+#include "LatencyHistogram.h"
+
+struct test_stats {
+    int total = 0;
+    int passed = 0;
+};
+
+static void report(test_stats& stats, const char* name, bool passed)
+{
+    stats.total++;
+    if (passed) stats.passed++;
+    std::printf("  [%s] %s\n", passed ? "PASS" : "FAIL", name);
+}
+
+static struct can_frame make_frame(uint32_t id, uint32_t code, uint32_t val)
+{
+    struct can_frame f {};
+    f.can_id = id;
+    f.can_dlc = 8;
+    pack_u32(f.data, code, val);
+    return f;
+}
+
+/* ============================================================================
+ * CanPending
+ * ============================================================================ */
+
+static void test_pending(test_stats& stats)
+{
+    std::printf("\n========== CanPending 匹配 ==========\n");
+
+    /* 只认领本块的 OFFSET，过期 ACK 丢弃，错误码不检查偏移 */
+    CanPending slot(CanPending::CodeBit(FW_CODE_OFFSET) | CanPending::CodeBit(FW_CODE_FLASH_ERROR));
+    slot.minOffset = slot.maxOffset = 128;
+    bool passed = !slot.Match(make_frame(PLATFORM_TX, FW_CODE_OFFSET, 64)) &&
+                  !slot.Match(make_frame(FW_DATA_RX, FW_CODE_OFFSET, 128)) &&
+                  !slot.Match(make_frame(PLATFORM_TX, FW_CODE_VERSION, 128)) &&
+                  slot.Match(make_frame(PLATFORM_TX, FW_CODE_OFFSET, 128)) &&
+                  slot.done && slot.code == FW_CODE_OFFSET && slot.val == 128 &&
+                  !slot.Match(make_frame(PLATFORM_TX, FW_CODE_OFFSET, 128));
+    report(stats, "OFFSET 按 ID、响应码和偏移匹配", passed);
+
+    CanPending err(CanPending::CodeBit(FW_CODE_OFFSET) | CanPending::CodeBit(FW_CODE_FLASH_ERROR));
+    err.maxOffset = 0;
+    passed = err.Match(make_frame(PLATFORM_TX, FW_CODE_FLASH_ERROR, 4096)) && err.code == FW_CODE_FLASH_ERROR;
+    report(stats, "错误码不检查偏移", passed);
+
+    CanPending shortFrame(CanPending::CodeBit(FW_CODE_VERSION));
+    struct can_frame f = make_frame(PLATFORM_TX, FW_CODE_VERSION, 0x01020300);
+    f.can_dlc = 4;
+    struct can_frame big = make_frame(PLATFORM_TX, 40, 0);
+    passed = !shortFrame.Match(f) && !shortFrame.Match(big) && !shortFrame.done;
+    report(stats, "短帧和越界响应码不认领", passed);
+}
+
+/* ============================================================================
+ * LatencyHistogram
+ * ============================================================================ */
+
+static void test_histogram(test_stats& stats)
+{
+    std::printf("\n========== LatencyHistogram ==========\n");
+
+    LatencyHistogram h;
+    bool passed = h.Count() == 0 && h.Percentile(50) == 0;
+    for (uint64_t v = 1; v <= 31; v++) h.Record(v);
+    passed = passed && h.Count() == 31 && h.Min() == 1 && h.Max() == 31 &&
+             h.Percentile(50) == 16 && h.Percentile(100) == 31 && h.Mean() == 16.0;
+    report(stats, "32 以下逐值计数", passed);
+
+    /* 对数区间：百分位取桶上界，相对误差不超过 1/32 */
+    h.Reset();
+    for (uint64_t v = 1; v <= 100000; v++) h.Record(v);
+    passed = true;
+    for (double p : {10.0, 50.0, 90.0, 99.0, 99.9}) {
+        double exact = p * 1000.0;
+        double got = static_cast<double>(h.Percentile(p));
+        passed = passed && got >= exact && (got - exact) / exact <= 1.0 / 32;
+    }
+    passed = passed && h.Percentile(100) == 100000 && h.Max() == 100000;
+    report(stats, "百分位相对误差 <= 1/32", passed);
+
+    h.Reset();
+    h.Record(uint64_t(1) << 40);
+    passed = h.Count() == 1 && h.Max() == (uint64_t(1) << 26) - 1;
+    report(stats, "超出上限的值截断", passed);
+}
+
+/* ============================================================================
+ * CanPacer
+ * ============================================================================ */
+
+static struct can_frame error_frame(canid_t cls, uint8_t ctrl = 0, int counter = -1)
+{
+    struct can_frame f {};
+    f.can_id = CAN_ERR_FLAG | cls;
+    f.can_dlc = 8;
+    f.data[1] = ctrl;
+    if (counter >= 0) {
+        f.can_id |= CAN_ERR_CNT;
+        f.data[6] = static_cast<uint8_t>(counter);
+    }
+    return f;
+}
+
+static void test_pacer(test_stats& stats)
+{
+    std::printf("\n========== CanPacer AIMD ==========\n");
+
+    CanPacer p(128, 1000000);
+    bool passed = p.Window() == 128 && p.GapUs() == 0 && p.Allow(16, 0) == 16;
+    report(stats, "初始为最大窗口、不限速", passed);
+
+    /* 同一轮 ACK 之间多次 ENOBUFS 只退避一次 */
+    p.OnCongestion();
+    p.OnCongestion();
+    passed = p.Window() == 64 && p.GapUs() == 111 && p.Backoffs() == 1;
+    p.OnAck();
+    passed = passed && p.Window() == 64;
+    for (int i = 0; i < 20; i++) p.OnAck();
+    passed = passed && p.Window() == 128 && p.GapUs() == 0;
+    report(stats, "ENOBUFS 减半，干净 ACK 恢复", passed);
+
+    CanPacer r(128, 1000000);
+    r.OnReceiverOverflow();
+    passed = r.Window() == 64 && r.GapUs() == 0;
+    report(stats, "bootloader 溢出只收窄窗口", passed);
+
+    passed = p.OnErrorFrame(error_frame(CAN_ERR_CRTL, CAN_ERR_CRTL_TX_WARNING)) &&
+             p.State() == CanBusState::Warning &&
+             p.OnErrorFrame(error_frame(CAN_ERR_CRTL, CAN_ERR_CRTL_TX_PASSIVE)) &&
+             p.State() == CanBusState::Passive && p.Window() == 64 && p.GapUs() >= 444;
+    for (int i = 0; i < 5; i++) p.OnAck();
+    passed = passed && p.Window() == 64;
+    report(stats, "错误被动降到最小窗口且不再增长", passed);
+
+    passed = p.OnErrorFrame(error_frame(CAN_ERR_BUSOFF)) && p.State() == CanBusState::BusOff &&
+             p.GapUs() == FW_GAP_MAX_US &&
+             !p.OnErrorFrame(error_frame(CAN_ERR_CRTL, 0, 10)) &&
+             p.OnErrorFrame(error_frame(CAN_ERR_RESTARTED)) && p.State() == CanBusState::Active &&
+             CanPacer::Classify(error_frame(CAN_ERR_CRTL, 0, 130), CanBusState::Active) == CanBusState::Passive;
+    report(stats, "总线关闭与错误计数器", passed);
+
+    /* 令牌桶：空闲后最多一个突发，之后按 帧时长 + gap 放行 */
+    int64_t t = 1000000000;
+    size_t n = p.Allow(16, t);
+    p.OnSent(n, t);
+    passed = n == FW_PACE_BURST && p.Allow(16, t) == 0 && p.DelayMs(t) >= 20 &&
+             p.Allow(16, t + (111 + FW_GAP_MAX_US) * 1000) == 1;
+    for (int i = 0; i < 40; i++) p.OnAck();
+    passed = passed && p.GapUs() == 0 && p.Window() == 128;
+    report(stats, "帧间隔令牌桶", passed);
+}
+
+/* ============================================================================
+ * socketpair 模拟 bootloader
+ * ============================================================================ */
+
+struct FakeBoot {
+    std::vector<uint8_t> received;
+    int overflowEvery = 0;      /* 每 N 个数据帧模拟一次接收溢出 */
+    size_t closeAfter = 0;      /* 收到这么多字节后关闭连接 */
+};
+
+static void reply(int fd, uint32_t code, uint32_t val)
+{
+    struct can_frame r = make_frame(PLATFORM_TX, code, val);
+    if (write(fd, &r, sizeof(r)) != sizeof(r)) return;
+}
+
+static void run_boot(int fd, size_t total, FakeBoot* boot)
+{
+    size_t recv = 0;
+    size_t blockStart = 0;
+    bool resync = false;
+    int frames = 0;
+    struct can_frame f;
+    while (read(fd, &f, sizeof(f)) == sizeof(f)) {
+        if (f.can_id == PLATFORM_RX) {
+            uint32_t code = 0, val = 0;
+            unpack_u32(f.data, &code, &val);
+            if (code == BOARD_RESUME) {
+                resync = (val != recv);
+                reply(fd, resync ? FW_CODE_TRANFER_ERROR : FW_CODE_OFFSET, static_cast<uint32_t>(recv));
+            }
+            continue;
+        }
+        if (resync) continue;
+        if (boot->overflowEvery && ++frames % boot->overflowEvery == 0) {
+            /* 丢弃本块已收数据，从块起点重传 */
+            recv = blockStart;
+            boot->received.resize(recv);
+            resync = true;
+            reply(fd, FW_CODE_RX_OVERFLOW, static_cast<uint32_t>(recv));
+            continue;
+        }
+        boot->received.insert(boot->received.end(), f.data, f.data + f.can_dlc);
+        recv += f.can_dlc;
+        if (boot->closeAfter && recv >= boot->closeAfter) break;
+        if (recv % FW_ACK_BLOCK == 0 || recv >= total) {
+            blockStart = recv;
+            reply(fd, recv >= total ? FW_CODE_UPDATE_SUCCESS : FW_CODE_OFFSET, static_cast<uint32_t>(recv));
+            if (recv >= total) break;
+        }
+    }
+    close(fd);
+}
+
+static bool make_image(const std::vector<uint8_t>& data, FirmwareImage& image)
+{
+    char path[] = "/tmp/test_can_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) return false;
+    bool ok = write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size());
+    close(fd);
+    std::string error;
+    ok = ok && image.Open(path, error);
+    unlink(path);
+    return ok;
+}
+
+static void test_receiver(test_stats& stats)
+{
+    std::printf("\n========== CanReceiver ==========\n");
+
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sv) < 0) {
+        report(stats, "socketpair", false);
+        return;
+    }
+    fcntl(sv[0], F_SETFL, O_NONBLOCK);
+
+    /* 多于一批的帧在一次 Drain 中全部取出，并带上接收时间 */
+    const int count = CAN_RX_BATCH + 5;
+    for (int i = 0; i < count; i++) reply(sv[1], FW_CODE_OFFSET, static_cast<uint32_t>(i));
+    CanReceiver rx(sv[0]);
+    std::vector<uint32_t> seen;
+    bool stamped = true;
+    int n = rx.Drain([&](const struct can_frame& f, int64_t rxNs) {
+        uint32_t code = 0, val = 0;
+        unpack_u32(f.data, &code, &val);
+        seen.push_back(val);
+        stamped = stamped && rxNs > 0;
+    });
+    bool passed = n == count && static_cast<int>(seen.size()) == count && stamped &&
+                  seen.front() == 0 && seen.back() == static_cast<uint32_t>(count - 1) &&
+                  rx.Drain([](const struct can_frame&, int64_t) {}) == 0;
+    report(stats, "批量取空接收队列", passed);
+
+    /* 对端关闭时 recvmmsg 返回长度 0 的消息，视为连接断开 */
+    close(sv[1]);
+    errno = 0;
+    n = rx.Drain([](const struct can_frame&, int64_t) {});
+    report(stats, "对端关闭返回 ECONNRESET", n < 0 && errno == ECONNRESET);
+    close(sv[0]);
+}
+
+static void test_transfer(test_stats& stats, const char* name, size_t size, FakeBoot boot, bool expectOk)
+{
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) data[i] = static_cast<uint8_t>((i * 2654435761u) >> 13);
+    FirmwareImage image;
+    int sv[2];
+    if (!make_image(data, image) || socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sv) < 0) {
+        report(stats, name, false);
+        return;
+    }
+    fcntl(sv[0], F_SETFL, O_NONBLOCK);
+
+    std::thread peer(run_boot, sv[1], size, &boot);
+    CanTransfer transfer(sv[0], image, 1000000);
+    size_t lastAcked = 0;
+    bool monotonic = true;
+    transfer.SetProgressCallback([&](size_t acked, size_t total) {
+        monotonic = monotonic && acked > lastAcked && total == size;
+        lastAcked = acked;
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = transfer.Run(2000);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    peer.join();
+    close(sv[0]);
+
+    const TransferStats& st = transfer.Stats();
+    bool passed;
+    if (expectOk) {
+        passed = ok && boot.received == data && monotonic && lastAcked == size &&
+                 st.acks > 0 && st.rtt.Count() > 0 &&
+                 (boot.overflowEvery == 0 || (st.resumes > 0 && st.backoffs > 0));
+    } else {
+        /* 断开应立即失败，而不是等到 ACK 超时 */
+        passed = !ok && transfer.Failed() && seconds < 1.0;
+    }
+    report(stats, name, passed);
+}
+
+int main()
+{
+    test_stats stats;
+
+    test_pending(stats);
+    test_histogram(stats);
+    test_pacer(stats);
+    test_receiver(stats);
+
+    std::printf("\n========== CanTransfer (socketpair) ==========\n");
+    test_transfer(stats, "完整传输", 100003, FakeBoot{}, true);
+    FakeBoot overflow;
+    overflow.overflowEvery = 37;
+    test_transfer(stats, "接收溢出后 RESUME 重传", 20000, overflow, true);
+    FakeBoot disconnect;
+    disconnect.closeAfter = 4000;
+    test_transfer(stats, "传输中对端断开", 20000, disconnect, false);
+
+    std::printf("\n  通过: %d / %d\n\n", stats.passed, stats.total);
+    return (stats.passed == stats.total) ? 0 : 1;
+}
@@ -4,6 +4,8 @@
  *
  * 基于 crcmod (Python) 的算法实现，使用纯位运算计算CRC，
  * 不依赖查找表，适用于ROM/RAM受限的嵌入式系统。
+ * 另提供可选的按字节查表实现（crc_table_init/crc_update_table），
+ * 用于主机侧对整个固件镜像等大块数据计算校验。
  *
  * 核心算法原理：
  * 1. CRC是循环冗余校验码，通过多项式除法计算
@@ -32,6 +34,9 @@ extern "C" {
 /** @brief 最大支持的多项式位数 */
 #define CRC_MAX_BITS 64
 
+/** @brief 查表法表项数（按字节索引） */
+#define CRC_TABLE_ENTRIES 256
+
 /* ============================================================================
  * 数据结构
  * ============================================================================ */
@@ -278,6 +283,38 @@ uint64_t crc_update(const uint8_t *data, size_t len,
  */
 uint64_t crc_finalize(uint64_t crc, const crc_config_t *config);
 
+/* ============================================================================
+ * 查表法（可选）
+ * ============================================================================ */
+
+/**
+ * @brief 生成按字节索引的CRC表
+ *
+ * 表项i为单字节i在CRC初值为0时经_byte_crc_forward/_byte_crc_reverse
+ * 计算的结果，适用于任意 crc_config_t（宽度 8~64 位）。
+ *
+ * @param table 输出表（CRC_TABLE_ENTRIES项）
+ * @param config CRC配置参数
+ */
+void crc_table_init(uint64_t table[CRC_TABLE_ENTRIES], const crc_config_t *config);
+
+/**
+ * @brief 使用查表法分段计算CRC值
+ *
+ * 结果与crc_update()逐位一致，每字节只需一次查表。
+ * 宽度不超过32位时内部以32位寄存器运算。
+ *
+ * @param data 输入数据缓冲区
+ * @param len 数据长度
+ * @param crc 当前CRC值
+ * @param table 由crc_table_init()生成的表
+ * @param config CRC配置参数
+ * @return uint64_t 更新后的CRC值
+ */
+uint64_t crc_update_table(const uint8_t *data, size_t len, uint64_t crc,
+                          const uint64_t table[CRC_TABLE_ENTRIES],
+                          const crc_config_t *config);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,258 @@
+/**
+ * @file crc.hpp
+ * @brief 纯头文件 C++20 constexpr CRC 模板
+ *
+ * 以 crc::config 作为模板参数，字节表在编译期生成，结果可在编译期求值：
+ *
+ * @code
+ * static_assert(crc::crc_32::compute("123456789") == 0xCBF43926);
+ * uint16_t v = crc::modbus::compute(std::span(buf, len));
+ * @endcode
+ *
+ * 寄存器类型按宽度选择（8位用uint8_t、16位用uint16_t、24/32位用uint32_t、64位用uint64_t），
+ * 语义与C库 crc_calc() 一致（crcmod 的"首尾异或"、reverse 同时控制算法方向和输入反转）。
+ * 预定义配置与 crc_api.c 的配置表一一对应，tests/test_crc_hpp.cpp 逐项交叉校验。
+ *
+ * @date 2026-10-18
+ * @license MIT
+ */
+
+#ifndef CRC_HPP
+#define CRC_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace crc {
+
+/* ============================================================================
+ * 配置
+ * ============================================================================ */
+
+/**
+ * @brief CRC算法配置（字段含义同 crc_config_t，refin 即 reverse）
+ */
+struct config {
+    std::uint64_t poly;     /**< 生成多项式（不含最高位） */
+    std::uint64_t init;     /**< 初始CRC值 */
+    std::uint64_t xor_out;  /**< 最终异或输出值 */
+    std::uint8_t width;     /**< CRC宽度（8~64） */
+    bool reverse;           /**< 是否使用位反转算法 */
+    bool refout;            /**< 输出结果是否位反转 */
+};
+
+namespace detail {
+
+/** @brief 按宽度选择最窄的寄存器类型 */
+template <std::uint8_t Width>
+using register_t = std::conditional_t<(Width <= 8), std::uint8_t,
+                   std::conditional_t<(Width <= 16), std::uint16_t,
+                   std::conditional_t<(Width <= 32), std::uint32_t, std::uint64_t>>>;
+
+constexpr std::uint64_t width_mask(std::uint8_t width)
+{
+    return (width == 64) ? UINT64_MAX : ((1ULL << width) - 1);
+}
+
+constexpr std::uint64_t bit_reverse(std::uint64_t x, std::uint8_t n)
+{
+    std::uint64_t y = 0;
+    for (std::uint8_t i = 0; i < n; i++) {
+        y = (y << 1) | (x & 1);
+        x >>= 1;
+    }
+    return y;
+}
+
+} // namespace detail
+
+/* ============================================================================
+ * 计算模板
+ * ============================================================================ */
+
+/**
+ * @brief 按配置特化的CRC计算器
+ *
+ * @tparam C CRC配置
+ */
+template <config C>
+class engine {
+    static_assert(C.width >= 8 && C.width <= 64, "CRC width must be 8..64");
+
+public:
+    using value_type = detail::register_t<C.width>;
+
+    static constexpr value_type mask = static_cast<value_type>(detail::width_mask(C.width));
+
+    /** @brief 编译期生成的字节表 */
+    static constexpr std::array<value_type, 256> table = [] {
+        std::array<value_type, 256> t{};
+        const std::uint64_t m = detail::width_mask(C.width);
+        const std::uint64_t poly = C.reverse ? detail::bit_reverse(C.poly & m, C.width)
+                                             : (C.poly & m);
+
+        for (std::uint32_t i = 0; i < 256; i++) {
+            std::uint64_t r;
+            if (C.reverse) {
+                r = i;
+                for (int b = 0; b < 8; b++) {
+                    r = (r & 1) ? (r >> 1) ^ poly : (r >> 1);
+                }
+            } else {
+                r = static_cast<std::uint64_t>(i) << (C.width - 8);
+                for (int b = 0; b < 8; b++) {
+                    r = ((r >> (C.width - 1)) & 1) ? (r << 1) ^ poly : (r << 1);
+                }
+            }
+            t[i] = static_cast<value_type>(r & m);
+        }
+        return t;
+    }();
+
+    /** @brief 初始寄存器值（已应用"首尾异或"） */
+    static constexpr value_type init()
+    {
+        return static_cast<value_type>((C.init ^ C.xor_out) & mask);
+    }
+
+    /** @brief 分段更新寄存器 */
+    static constexpr value_type update(value_type crc, std::span<const std::uint8_t> data)
+    {
+        for (std::uint8_t b : data) {
+            crc = step(crc, b);
+        }
+        return crc;
+    }
+
+    static constexpr value_type update(value_type crc, std::string_view data)
+    {
+        for (char ch : data) {
+            crc = step(crc, static_cast<std::uint8_t>(ch));
+        }
+        return crc;
+    }
+
+    static value_type update(value_type crc, const void *data, std::size_t len)
+    {
+        return update(crc, std::span(static_cast<const std::uint8_t *>(data), len));
+    }
+
+    /** @brief 完成计算（输出异或与输出反转） */
+    static constexpr value_type finalize(value_type crc)
+    {
+        std::uint64_t r = (crc ^ C.xor_out) & mask;
+        if (C.refout) {
+            r = detail::bit_reverse(r, C.width);
+        }
+        return static_cast<value_type>(r & mask);
+    }
+
+    /** @brief 一次性计算，等价于 crc_calc() */
+    static constexpr value_type compute(std::span<const std::uint8_t> data)
+    {
+        return finalize(update(init(), data));
+    }
+
+    static constexpr value_type compute(std::string_view data)
+    {
+        return finalize(update(init(), data));
+    }
+
+    static value_type compute(const void *data, std::size_t len)
+    {
+        return finalize(update(init(), data, len));
+    }
+
+private:
+    static constexpr value_type step(value_type crc, std::uint8_t b)
+    {
+        if constexpr (C.reverse) {
+            return static_cast<value_type>(table[(crc ^ b) & 0xFF] ^ (crc >> 8));
+        } else if constexpr (C.width == 8) {
+            return table[crc ^ b];
+        } else {
+            return static_cast<value_type>(
+                (table[((crc >> (C.width - 8)) ^ b) & 0xFF] ^ (crc << 8)) & mask);
+        }
+    }
+};
+
+/* ============================================================================
+ * 预定义算法（与 crc_api.c 配置表对应）
+ * 参数：多项式, 初始值, 输出异或, 宽度, reverse, refout
+ * ============================================================================ */
+
+namespace cfg {
+/* 8位 */
+inline constexpr config crc_8          {0x07, 0x00, 0x00, 8, false, false};
+inline constexpr config crc_8_darc     {0x39, 0x00, 0x00, 8, true, false};
+inline constexpr config crc_8_i_code   {0x1D, 0xFD, 0x00, 8, false, false};
+inline constexpr config crc_8_itu      {0x07, 0x55, 0x55, 8, false, false};
+inline constexpr config crc_8_maxim    {0x31, 0x00, 0x00, 8, true, false};
+inline constexpr config crc_8_rohc     {0x07, 0xFF, 0x00, 8, true, false};
+inline constexpr config crc_8_wcdma    {0x9B, 0x00, 0x00, 8, true, false};
+
+/* 16位 */
+inline constexpr config crc_16         {0x8005, 0x0000, 0x0000, 16, true, false};
+inline constexpr config crc_16_bypass  {0x8005, 0x0000, 0x0000, 16, false, false};
+inline constexpr config crc_16_dds_110 {0x8005, 0x800D, 0x0000, 16, false, false};
+inline constexpr config crc_16_dect    {0x0589, 0x0001, 0x0001, 16, false, false};
+inline constexpr config crc_16_dnp     {0x3D65, 0xFFFF, 0xFFFF, 16, true, false};
+inline constexpr config crc_16_en_13757{0x3D65, 0xFFFF, 0xFFFF, 16, false, false};
+inline constexpr config crc_16_genibus {0x1021, 0x0000, 0xFFFF, 16, false, false};
+inline constexpr config crc_16_maxim   {0x8005, 0xFFFF, 0xFFFF, 16, true, false};
+inline constexpr config crc_16_mcrf4xx {0x1021, 0xFFFF, 0x0000, 16, true, false};
+inline constexpr config crc_16_riello  {0x1021, 0x554D, 0x0000, 16, true, false};
+inline constexpr config crc_16_t10_dif {0x8BB7, 0x0000, 0x0000, 16, false, false};
+inline constexpr config crc_16_teledisk{0xA097, 0x0000, 0x0000, 16, false, false};
+inline constexpr config crc_16_usb     {0x8005, 0x0000, 0xFFFF, 16, true, false};
+inline constexpr config x25            {0x1021, 0x0000, 0xFFFF, 16, true, false};
+inline constexpr config xmodem         {0x1021, 0x0000, 0x0000, 16, false, false};
+inline constexpr config modbus         {0x8005, 0xFFFF, 0x0000, 16, true, false};
+inline constexpr config ccitt_false    {0x1021, 0xFFFF, 0x0000, 16, false, false};
+inline constexpr config aug_ccitt      {0x1021, 0x1D0F, 0x0000, 16, false, false};
+inline constexpr config kermit         {0x1021, 0x0000, 0x0000, 16, true, false};
+
+/* 24位 */
+inline constexpr config crc_24           {0x864CFB, 0xB704CE, 0x000000, 24, false, false};
+inline constexpr config crc_24_flexray_a {0x5D6DCB, 0xFEDCBA, 0x000000, 24, false, false};
+inline constexpr config crc_24_flexray_b {0x5D6DCB, 0xABCDEF, 0x000000, 24, false, false};
+
+/* 32位 */
+inline constexpr config crc_32       {0x04C11DB7, 0x00000000, 0xFFFFFFFF, 32, true, false};
+inline constexpr config crc_32_bzip2 {0x04C11DB7, 0x00000000, 0xFFFFFFFF, 32, false, false};
+inline constexpr config crc_32c      {0x1EDC6F41, 0x00000000, 0xFFFFFFFF, 32, true, false};
+inline constexpr config crc_32d      {0xA833982B, 0x00000000, 0xFFFFFFFF, 32, true, false};
+inline constexpr config crc_32_mpeg  {0x04C11DB7, 0xFFFFFFFF, 0x00000000, 32, false, false};
+inline constexpr config posix        {0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, 32, false, false};
+inline constexpr config crc_32q      {0x814141AB, 0x00000000, 0x00000000, 32, false, false};
+inline constexpr config jamcrc       {0x04C11DB7, 0xFFFFFFFF, 0x00000000, 32, true, false};
+inline constexpr config xfer         {0x000000AF, 0x00000000, 0x00000000, 32, false, false};
+
+/* 64位 */
+inline constexpr config crc_64       {0x000000000000001B, 0x0000000000000000, 0x0000000000000000, 64, true, false};
+inline constexpr config crc_64_we    {0x42F0E1EBA9EA3693, 0x0000000000000000, 0xFFFFFFFFFFFFFFFF, 64, false, false};
+inline constexpr config crc_64_jones {0xAD93D23594C935A9, 0xFFFFFFFFFFFFFFFF, 0x0000000000000000, 64, true, false};
+} // namespace cfg
+
+/* 常用算法别名 */
+using crc_8         = engine<cfg::crc_8>;
+using crc_16        = engine<cfg::crc_16>;
+using modbus        = engine<cfg::modbus>;
+using xmodem        = engine<cfg::xmodem>;
+using kermit        = engine<cfg::kermit>;
+using zephyr_ccitt  = kermit;   /**< Zephyr crc16_ccitt()（seed 0） */
+using ccitt_false   = engine<cfg::ccitt_false>;
+using crc_32        = engine<cfg::crc_32>;
+using crc_32c       = engine<cfg::crc_32c>;
+using crc_32_mpeg   = engine<cfg::crc_32_mpeg>;
+using crc_64        = engine<cfg::crc_64>;
+using crc_64_we     = engine<cfg::crc_64_we>;
+
+} // namespace crc
+
+#endif /* CRC_HPP */
@@ -14,6 +14,10 @@
 #define CRC_API_H
 
 #include "crc.h"
+#include "crc_slice.h"
+#include "crc_clmul.h"
+#include "crc_sse42.h"
+#include "crc_combine.h"
 #include <stddef.h>
 #include <stdint.h>
 
@@ -63,6 +67,7 @@ typedef enum {
     CRC_CCITT_FALSE,    /**< False CCITT (多项式 0x1021, 初始值 0xFFFF) */
     CRC_AUG_CCITT,      /**< Augmented CCITT */
     CRC_KERMIT,         /**< Kermit协议 */
+    CRC_ZEPHYR_CCITT = CRC_KERMIT, /**< Zephyr crc16_ccitt()（seed 0），与KERMIT逐位一致 */
     CRC_XMODEM,         /**< XMODEM协议 */
     CRC_X25,            /**< X.25协议 */
 
@@ -125,6 +130,11 @@ int crc_get_check_value(crc_type_t type, uint64_t *check_value);
 /**
  * @brief 使用预定义算法计算CRC
  *
+ * CRC-32C在CPU支持SSE4.2时任意长度都使用crc32指令；
+ * 数据长度不小于 CRC_CLMUL_MIN_LEN 且CPU支持PCLMULQDQ时使用折叠内核；
+ * 32/64位算法在数据长度不小于 CRC_SLICE_MIN_LEN 时使用slicing-by-16。
+ * 结果均与逐位计算一致。
+ *
  * @param type CRC算法类型
  * @param data 输入数据
  * @param len 数据长度
@@ -132,10 +142,61 @@ int crc_get_check_value(crc_type_t type, uint64_t *check_value);
  */
 uint64_t crc_compute(crc_type_t type, const uint8_t *data, size_t len);
 
+/**
+ * @brief 批量计算多个缓冲区的CRC
+ *
+ * 算法配置只解析一次，每4个缓冲区交错计算以利用指令级并行，
+ * 适合大量短数据（CAN帧、差分刷写的逐页校验）。结果与逐个调用 crc_compute() 一致。
+ *
+ * @param type CRC算法类型
+ * @param bufs n个输入缓冲区（为NULL的项按空数据计算）
+ * @param lens n个数据长度
+ * @param out 输出n个CRC值
+ * @param n 缓冲区个数
+ * @return 0 成功, -1 失败（未知类型或参数为NULL）
+ */
+int crc_compute_many(crc_type_t type, const uint8_t *const *bufs, const size_t *lens,
+                     uint64_t *out, size_t n);
+
+/** @brief crc_compute_parallel() 的最大线程数 */
+#define CRC_PARALLEL_MAX_THREADS 64
+
+/** @brief crc_compute_parallel() 每线程最少处理的字节数，过小时线程开销超过收益 */
+#define CRC_PARALLEL_MIN_CHUNK (1024u * 1024u)
+
+/**
+ * @brief 多线程计算大块数据的CRC
+ *
+ * 数据按线程数等分，各线程独立调用 crc_compute()，结果经 crc_combine() 合并，
+ * 与 crc_compute() 结果一致。每线程分得的数据不足 CRC_PARALLEL_MIN_CHUNK 时
+ * 减少线程数，不足两块时直接在调用线程计算。
+ *
+ * @param type CRC算法类型
+ * @param data 输入数据
+ * @param len 数据长度
+ * @param threads 线程数（含调用线程），0 表示使用在线CPU核数
+ * @return uint64_t CRC值
+ */
+uint64_t crc_compute_parallel(crc_type_t type, const uint8_t *data, size_t len,
+                              unsigned threads);
+
 /* ============================================================================
  * 上下文接口 - 流式处理
  * ============================================================================ */
 
+/**
+ * @brief CRC计算模式
+ */
+typedef enum {
+    CRC_MODE_BITWISE = 0,   /**< 逐位计算（默认，无额外内存） */
+    CRC_MODE_TABLE,         /**< 按字节查表（首次更新时生成256项表） */
+    CRC_MODE_SLICE8,        /**< slicing-by-8（仅32/64位，使用共享表） */
+    CRC_MODE_SLICE16,       /**< slicing-by-16（仅32/64位，使用共享表） */
+    CRC_MODE_CLMUL,         /**< PCLMULQDQ折叠（CPU不支持时退化为字节表） */
+    CRC_MODE_SSE42,         /**< SSE4.2 crc32指令（仅CRC-32C，CPU不支持时退化为slicing-by-8） */
+    CRC_MODE_AUTO,          /**< 自动选择（CRC_USE_SLICING为0时退化为逐位计算） */
+} crc_mode_t;
+
 /**
  * @brief CRC计算上下文
  *
@@ -144,11 +205,18 @@ uint64_t crc_compute(crc_type_t type, const uint8_t *data, size_t len);
 typedef struct {
     crc_config_t config;    /**< CRC配置 */
     uint64_t crc;           /**< 当前CRC值 */
+    crc_mode_t mode;        /**< 计算模式 */
+    uint8_t table_ready;    /**< 查表模式下表是否已生成 */
+    const crc_slice_table_t *slice; /**< slicing模式使用的共享表 */
+    const crc_clmul_t *clmul;       /**< 折叠模式使用的共享常数 */
+    uint64_t table[CRC_TABLE_ENTRIES]; /**< 查表模式使用的表 */
 } crc_ctx_t;
 
 /**
  * @brief 初始化CRC上下文
  *
+ * 上下文默认逐位计算，不分配表；需要查表/slicing/折叠内核时调用 crc_set_mode()。
+ *
  * @param ctx 上下文结构体指针
  * @param type CRC算法类型
  * @return 0 成功, -1 失败
@@ -158,12 +226,29 @@ int crc_init(crc_ctx_t *ctx, crc_type_t type);
 /**
  * @brief 使用自定义配置初始化CRC上下文
  *
+ * 默认模式同 crc_init()。
+ *
  * @param ctx 上下文结构体指针
  * @param config CRC配置
  * @return 0 成功, -1 失败
  */
 int crc_init_custom(crc_ctx_t *ctx, const crc_config_t *config);
 
+/**
+ * @brief 设置CRC上下文的计算模式
+ *
+ * 切换到 CRC_MODE_TABLE 后，表在下一次 crc_update_ctx() 时按当前配置生成，
+ * 之后同一上下文（包括 crc_reset() 之后）复用该表。
+ * CRC_MODE_AUTO 对CRC-32C优先使用SSE4.2 crc32指令；
+ * 其他配置在CPU支持PCLMULQDQ且单次数据不小于 CRC_CLMUL_MIN_LEN 时使用折叠内核，
+ * 否则对32/64位配置使用slicing-by-16（短数据逐字节查同一组表），其他宽度使用字节表。
+ *
+ * @param ctx 上下文结构体指针（已初始化）
+ * @param mode 计算模式
+ * @return 0 成功, -1 失败（未知模式，或配置不支持所选slicing/SSE4.2模式）
+ */
+int crc_set_mode(crc_ctx_t *ctx, crc_mode_t mode);
+
 /**
  * @brief 更新CRC计算（流式处理）
  *
@@ -202,6 +287,19 @@ int crc_reset(crc_ctx_t *ctx);
  */
 const char *crc_get_name(crc_type_t type);
 
+/**
+ * @brief 按名称查找CRC算法类型
+ *
+ * 名称比较不区分大小写、忽略 '-' 和 '_'，并可省略或附加 "CRC_" 前缀，
+ * 因此 "CRC-32C"、"crc32c"、"CRC_32C"、"MODBUS"、"CRC_MODBUS"、"CRC_X25" 均可识别。
+ * 另识别别名 "ZEPHYR-CCITT"（即 KERMIT）。
+ *
+ * @param name 算法名称
+ * @param type 输出算法类型
+ * @return 0 成功, -1 失败（未知名称）
+ */
+int crc_get_type_by_name(const char *name, crc_type_t *type);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,99 @@
+/**
+ * @file crc_clmul.h
+ * @brief 无进位乘法（PCLMULQDQ）折叠CRC内核
+ *
+ * 将数据视为GF(2)多项式，每次把128位累加器乘以 x^k mod P 折叠到后续数据上，
+ * 4路并行时每次迭代处理64字节；最后16字节累加器及尾部数据经字节表得到CRC。
+ * 折叠常数在初始化时由 crc_config_t 推导，适用于任意8~64位（8的整数倍）配置，
+ * 前向与反向算法均支持。
+ *
+ * 运行时通过cpuid检测PCLMULQDQ/SSSE3，不支持的CPU或非x86平台自动退化为字节表实现。
+ *
+ * @date 2026-10-18
+ * @license MIT
+ */
+
+#ifndef CRC_CLMUL_H
+#define CRC_CLMUL_H
+
+#include "crc.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * 常量定义
+ * ============================================================================ */
+
+/** @brief 自动选择折叠内核的最小数据长度 */
+#define CRC_CLMUL_MIN_LEN 256
+
+/* ============================================================================
+ * 数据结构
+ * ============================================================================ */
+
+/**
+ * @brief 折叠内核上下文
+ *
+ * 每组常数为一对64位值，对应折叠距离d的 x^(d+64) mod P 与 x^d mod P
+ * （反向算法存放位反转后的 x^(d+63) 与 x^(d-1)，补偿反射域乘积的1位偏移）。
+ */
+typedef struct {
+    crc_config_t config;                    /**< 生成常数所用的配置 */
+    uint64_t k512[2];                       /**< 4路折叠（距离512位） */
+    uint64_t k384[2];                       /**< 合并第1路（距离384位） */
+    uint64_t k256[2];                       /**< 合并第2路（距离256位） */
+    uint64_t k128[2];                       /**< 单路折叠/合并第3路（距离128位） */
+    uint64_t table[CRC_TABLE_ENTRIES];      /**< 首尾数据使用的字节表 */
+} crc_clmul_t;
+
+/* ============================================================================
+ * 接口函数
+ * ============================================================================ */
+
+/**
+ * @brief 当前CPU是否支持折叠内核
+ *
+ * @return 1 支持, 0 不支持（crc_update_clmul()将退化为字节表）
+ */
+int crc_clmul_available(void);
+
+/**
+ * @brief 按配置推导折叠常数并生成字节表
+ *
+ * @param ctx 输出上下文
+ * @param config CRC配置参数（宽度须为8~64且为8的整数倍）
+ * @return 0 成功, -1 失败
+ */
+int crc_clmul_init(crc_clmul_t *ctx, const crc_config_t *config);
+
+/**
+ * @brief 获取配置对应的共享折叠上下文
+ *
+ * 首次使用时生成并缓存，以多项式/宽度/反向算法为键，多线程并发调用安全。
+ *
+ * @param config CRC配置参数
+ * @return const crc_clmul_t* 上下文指针；配置不支持、缓存已满或内存不足时返回NULL
+ */
+const crc_clmul_t *crc_clmul_get(const crc_config_t *config);
+
+/**
+ * @brief 使用折叠内核分段计算CRC值
+ *
+ * @param data 输入数据缓冲区
+ * @param len 数据长度
+ * @param crc 当前CRC值
+ * @param ctx 折叠内核上下文
+ * @return uint64_t 更新后的CRC值（与crc_update()结果一致）
+ */
+uint64_t crc_update_clmul(const uint8_t *data, size_t len, uint64_t crc,
+                          const crc_clmul_t *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRC_CLMUL_H */
@@ -0,0 +1,81 @@
+/**
+ * @file crc_combine.h
+ * @brief CRC合并与零字节/填充字节扩展运算
+ *
+ * CRC寄存器更新是GF(2)上的仿射变换：处理n个字节后的寄存器等于
+ * "初始寄存器经n个零字节移位"与"数据自身贡献"之和（异或）。
+ * 因此已知两段数据各自的CRC，即可用"追加n个零字节"算子合并得到整段的CRC，
+ * 无需重新遍历数据。该算子为 width×width 的GF(2)矩阵，按n的二进制位
+ * 反复平方求幂，耗时 O(width² · log n)，与数据长度基本无关。
+ *
+ * 适用于任意 crc_config_t（8~64位、前向/反向、任意初值/输出异或/输出反转），
+ * 输入输出均为 crc_calc() 意义上的最终CRC值。
+ *
+ * @date 2026-10-18
+ * @license MIT
+ */
+
+#ifndef CRC_COMBINE_H
+#define CRC_COMBINE_H
+
+#include "crc.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 合并两段数据的CRC
+ *
+ * 已知 crc_a = crc_calc(A)、crc_b = crc_calc(B)，求 crc_calc(A || B)。
+ *
+ * @param crc_a 前段数据的CRC
+ * @param crc_b 后段数据的CRC
+ * @param len_b 后段数据长度（字节）
+ * @param config CRC配置参数
+ * @return uint64_t 整段数据的CRC，config为NULL时返回0
+ *
+ * @example
+ * @code
+ * uint64_t a = crc_calc(buf, 1000, &cfg);
+ * uint64_t b = crc_calc(buf + 1000, 24, &cfg);
+ * crc_combine(a, b, 24, &cfg) == crc_calc(buf, 1024, &cfg);
+ * @endcode
+ */
+uint64_t crc_combine(uint64_t crc_a, uint64_t crc_b, uint64_t len_b,
+                     const crc_config_t *config);
+
+/**
+ * @brief 在数据后追加n个相同字节后的CRC
+ *
+ * 已知 crc = crc_calc(A)，求 crc_calc(A || fill × n)，耗时 O(log n)。
+ * fill 取 0xFF 时可直接得到已擦除Flash区域的CRC。
+ *
+ * @param crc 原数据的CRC
+ * @param n 追加字节数
+ * @param fill 追加的字节值
+ * @param config CRC配置参数
+ * @return uint64_t 追加后的CRC，config为NULL时返回0
+ */
+uint64_t crc_append_fill(uint64_t crc, uint64_t n, uint8_t fill,
+                         const crc_config_t *config);
+
+/**
+ * @brief 在数据后追加n个零字节后的CRC
+ *
+ * 等价于 crc_append_fill(crc, n, 0x00, config)。
+ *
+ * @param crc 原数据的CRC
+ * @param n 追加字节数
+ * @param config CRC配置参数
+ * @return uint64_t 追加后的CRC，config为NULL时返回0
+ */
+uint64_t crc_append_zeros(uint64_t crc, uint64_t n, const crc_config_t *config);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRC_COMBINE_H */
@@ -0,0 +1,164 @@
+/**
+ * @file crc_nibble.h
+ * @brief 16/32位反向CRC半字节查表实现（纯头文件）
+ *
+ * 每字节查两次16项表，16位算法仅占32字节ROM，32位算法64字节。相对逐位运算省去
+ * 每字节8次移位和条件跳转，相对256项表（512/1024字节）节省ROM，适合 Cortex-M3 等
+ * Flash 受限的MCU及串口中断中的帧校验。
+ *
+ * 本文件不依赖库中其他文件，固件和上位机（C/C++）可直接包含：
+ * - crc16_modbus_nibble()：MODBUS（反向 0x8005，即 0xA001，初值 0xFFFF）
+ * - crc16_ccitt_zephyr_nibble()：Zephyr crc16_ccitt()（反向 0x1021，seed 0 时即 KERMIT）
+ * - crc32_nibble()：标准 CRC-32（反向 0x04C11DB7，与 zlib.crc32 一致）
+ *
+ * 结果与 crc_compute(CRC_MODBUS / CRC_KERMIT / CRC_32, ...) 一致。
+ *
+ * @date 2026-10-18
+ * @license MIT
+ */
+
+#ifndef CRC_NIBBLE_H
+#define CRC_NIBBLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 用半字节表更新16位反向CRC寄存器
+ *
+ * 表项 table[i] 为半字节 i 经4次反向移位后的寄存器值。
+ * 不处理初值和输出异或，可分段连续调用。
+ *
+ * @param crc 当前CRC寄存器值
+ * @param data 输入数据缓冲区
+ * @param len 数据长度
+ * @param table 16项半字节表
+ * @return uint16_t 更新后的寄存器值
+ */
+static inline uint16_t crc16_nibble_update(uint16_t crc, const uint8_t *data, size_t len,
+                                           const uint16_t table[16])
+{
+    while (len--) {
+        crc ^= *data++;
+        crc = (uint16_t)((crc >> 4) ^ table[crc & 0x0F]);
+        crc = (uint16_t)((crc >> 4) ^ table[crc & 0x0F]);
+    }
+    return crc;
+}
+
+/**
+ * @brief 分段计算MODBUS CRC
+ *
+ * 首段传入初值 0xFFFF，后续段传入上一段的返回值。
+ *
+ * @param crc 当前CRC值
+ * @param data 输入数据缓冲区
+ * @param len 数据长度
+ * @return uint16_t 更新后的CRC值
+ */
+static inline uint16_t crc16_modbus_nibble_update(uint16_t crc, const uint8_t *data, size_t len)
+{
+    static const uint16_t table[16] = {
+        0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
+        0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400,
+    };
+    return crc16_nibble_update(crc, data, len, table);
+}
+
+/**
+ * @brief 计算MODBUS CRC（反向 0xA001，初值 0xFFFF，无输出异或）
+ *
+ * @param data 输入数据缓冲区
+ * @param len 数据长度
+ * @return uint16_t CRC值
+ */
+static inline uint16_t crc16_modbus_nibble(const uint8_t *data, size_t len)
+{
+    return crc16_modbus_nibble_update(0xFFFF, data, len);
+}
+
+/**
+ * @brief 计算 Zephyr crc16_ccitt() 兼容的CRC（反向 0x8408，无输出异或）
+ *
+ * 与 Zephyr subsys/crc/crc16_sw.c 的 crc16_ccitt(seed, src, len) 参数和结果一致，
+ * seed 为上一段的返回值时可分段计算。
+ *
+ * @param seed 初值（首段通常为 0）
+ * @param data 输入数据缓冲区
+ * @param len 数据长度
+ * @return uint16_t CRC值
+ */
+static inline uint16_t crc16_ccitt_zephyr_nibble(uint16_t seed, const uint8_t *data, size_t len)
+{
+    static const uint16_t table[16] = {
+        0x0000, 0x1081, 0x2102, 0x3183, 0x4204, 0x5285, 0x6306, 0x7387,
+        0x8408, 0x9489, 0xA50A, 0xB58B, 0xC60C, 0xD68D, 0xE70E, 0xF78F,
+    };
+    return crc16_nibble_update(seed, data, len, table);
+}
+
+/**
+ * @brief 用半字节表更新32位反向CRC寄存器
+ *
+ * 与 crc16_nibble_update() 相同，寄存器为32位。不处理初值和输出异或。
+ *
+ * @param crc 当前CRC寄存器值
+ * @param data 输入数据缓冲区
+ * @param len 数据长度
+ * @param table 16项半字节表
+ * @return uint32_t 更新后的寄存器值
+ */
+static inline uint32_t crc32_nibble_update(uint32_t crc, const uint8_t *data, size_t len,
+                                           const uint32_t table[16])
+{
+    while (len--) {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+    }
+    return crc;
+}
+
+/**
+ * @brief 分段计算标准 CRC-32
+ *
+ * 参数和返回值为最终CRC值（已含输出异或），首段传入 0，
+ * 后续段传入上一段的返回值，与 zlib.crc32(data, crc) 用法相同。
+ *
+ * @param crc 上一段的CRC值（首段为 0）
+ * @param data 输入数据缓冲区
+ * @param len 数据长度
+ * @return uint32_t 更新后的CRC值
+ */
+static inline uint32_t crc32_nibble_continue(uint32_t crc, const uint8_t *data, size_t len)
+{
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+        0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    return crc32_nibble_update(crc ^ 0xFFFFFFFFu, data, len, table) ^ 0xFFFFFFFFu;
+}
+
+/**
+ * @brief 计算标准 CRC-32（反向 0xEDB88320，初值和输出异或 0xFFFFFFFF）
+ *
+ * @param data 输入数据缓冲区
+ * @param len 数据长度
+ * @return uint32_t CRC值
+ */
+static inline uint32_t crc32_nibble(const uint8_t *data, size_t len)
+{
+    return crc32_nibble_continue(0, data, len);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRC_NIBBLE_H */
@@ -0,0 +1,119 @@
+/**
+ * @file crc_slice.h
+ * @brief Slicing-by-8/16 CRC内核 - 32/64位CRC的多表并行实现
+ *
+ * 每次迭代处理8或16字节：将当前CRC与数据首部异或后拆分为字节，
+ * 每个字节查一张"向后推进k个零字节"的表，结果相互异或。
+ * 表按 crc_config_t（多项式、宽度、反向算法）生成，结果与逐位实现完全一致。
+ *
+ * 仅支持宽度为32和64位的配置（CRC_32、CRC_32C、CRC_32_MPEG、CRC_64、CRC_64_WE等）。
+ *
+ * @date 2026-10-18
+ * @license MIT
+ */
+
+#ifndef CRC_SLICE_H
+#define CRC_SLICE_H
+
+#include "crc.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * 常量定义
+ * ============================================================================ */
+
+/** @brief 是否自动选择slicing/折叠内核（需要malloc和C11原子操作，嵌入式可定义为0） */
+#ifndef CRC_USE_SLICING
+#define CRC_USE_SLICING 1
+#endif
+
+/** @brief 最多切片数（slicing-by-16） */
+#define CRC_SLICE_MAX 16
+
+/** @brief 自动选择slicing内核的最小数据长度 */
+#define CRC_SLICE_MIN_LEN 64
+
+/* ============================================================================
+ * 数据结构
+ * ============================================================================ */
+
+/**
+ * @brief Slicing表
+ *
+ * t32/t64[k][i] 为字节i之后再追加k个零字节的CRC贡献，t32/t64[0]即普通字节表。
+ * 32位CRC使用t32（16KB），64位CRC使用t64（32KB）。
+ */
+typedef struct {
+    crc_config_t config;                                /**< 生成表所用的配置 */
+    union {
+        uint32_t t32[CRC_SLICE_MAX][CRC_TABLE_ENTRIES]; /**< 32位CRC表 */
+        uint64_t t64[CRC_SLICE_MAX][CRC_TABLE_ENTRIES]; /**< 64位CRC表 */
+    };
+} crc_slice_table_t;
+
+/* ============================================================================
+ * 接口函数
+ * ============================================================================ */
+
+/**
+ * @brief 判断配置是否可使用slicing内核
+ *
+ * @param config CRC配置参数
+ * @return 1 支持（宽度为32或64位）, 0 不支持
+ */
+int crc_slice_supported(const crc_config_t *config);
+
+/**
+ * @brief 按配置生成slicing表
+ *
+ * @param tbl 输出表
+ * @param config CRC配置参数（宽度须为32或64位）
+ * @return 0 成功, -1 失败
+ */
+int crc_slice_init(crc_slice_table_t *tbl, const crc_config_t *config);
+
+/**
+ * @brief 获取配置对应的共享slicing表
+ *
+ * 表在首次使用时生成并缓存，以多项式/宽度/反向算法为键，
+ * 多线程并发调用安全（原子发布，无锁）。
+ *
+ * @param config CRC配置参数
+ * @return const crc_slice_table_t* 表指针；不支持的配置、缓存已满或内存不足时返回NULL
+ */
+const crc_slice_table_t *crc_slice_get(const crc_config_t *config);
+
+/**
+ * @brief 使用slicing-by-8分段计算CRC值
+ *
+ * @param data 输入数据缓冲区
+ * @param len 数据长度
+ * @param crc 当前CRC值
+ * @param tbl slicing表
+ * @return uint64_t 更新后的CRC值（与crc_update()结果一致）
+ */
+uint64_t crc_update_slice8(const uint8_t *data, size_t len, uint64_t crc,
+                           const crc_slice_table_t *tbl);
+
+/**
+ * @brief 使用slicing-by-16分段计算CRC值
+ *
+ * @param data 输入数据缓冲区
+ * @param len 数据长度
+ * @param crc 当前CRC值
+ * @param tbl slicing表
+ * @return uint64_t 更新后的CRC值（与crc_update()结果一致）
+ */
+uint64_t crc_update_slice16(const uint8_t *data, size_t len, uint64_t crc,
+                            const crc_slice_table_t *tbl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRC_SLICE_H */
@@ -217,3 +217,89 @@ uint64_t crc_calc_with_init(const uint8_t *data, size_t len,
 
     return crc;
 }
+
+/* ============================================================================
+ * 查表法实现
+ * ============================================================================ */
+
+/**
+ * @brief 生成按字节索引的CRC表
+ *
+ * @param table 输出表（CRC_TABLE_ENTRIES项）
+ * @param config CRC配置参数
+ */
+void crc_table_init(uint64_t table[CRC_TABLE_ENTRIES], const crc_config_t *config)
+{
+    if (table == NULL || config == NULL) {
+        return;
+    }
+
+    uint64_t poly = _prepare_poly(config->poly, config->reverse, config->width_bits);
+
+    for (uint32_t i = 0; i < CRC_TABLE_ENTRIES; i++) {
+        if (config->reverse) {
+            table[i] = _byte_crc_reverse(0, (uint8_t)i, poly, config->width_bits);
+        } else {
+            table[i] = _byte_crc_forward(0, (uint8_t)i, poly, config->width_bits);
+        }
+    }
+}
+
+/**
+ * @brief 使用查表法分段计算CRC值
+ *
+ * @param data 输入数据缓冲区
+ * @param len 数据长度
+ * @param crc 当前CRC值
+ * @param table 由crc_table_init()生成的表
+ * @param config CRC配置参数
+ * @return uint64_t 更新后的CRC值
+ *
+ * @算法说明：
+ * - 反向算法: crc = table[(crc ^ byte) & 0xFF] ^ (crc >> 8)
+ * - 前向算法: crc = table[((crc >> (width - 8)) ^ byte) & 0xFF] ^ (crc << 8)
+ * 两者都等价于对该字节执行8次_byte_crc_reverse/_byte_crc_forward的移位异或。
+ */
+uint64_t crc_update_table(const uint8_t *data, size_t len, uint64_t crc,
+                          const uint64_t table[CRC_TABLE_ENTRIES],
+                          const crc_config_t *config)
+{
+    if (config == NULL || data == NULL || table == NULL) {
+        return crc;
+    }
+
+    const uint8_t width = config->width_bits;
+    const uint64_t mask = _get_width_mask(width);
+    crc = crc & mask;
+
+    /* 宽度不超过32位时使用32位寄存器，避免在32位目标上做64位移位 */
+    if (width <= 32) {
+        uint32_t c = (uint32_t)crc;
+        const uint32_t mask32 = (uint32_t)mask;
+
+        if (config->reverse) {
+            for (size_t i = 0; i < len; i++) {
+                c = (uint32_t)table[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+            }
+        } else {
+            const uint8_t shift = width - 8;
+            for (size_t i = 0; i < len; i++) {
+                c = ((uint32_t)table[((c >> shift) ^ data[i]) & 0xFF] ^ (c << 8)) & mask32;
+            }
+        }
+        return c;
+    }
+
+    if (config->reverse) {
+        for (size_t i = 0; i < len; i++) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+    } else {
+        const uint8_t shift = width - 8;
+        for (size_t i = 0; i < len; i++) {
+            crc = (table[((crc >> shift) ^ data[i]) & 0xFF] ^ (crc << 8)) & mask;
+        }
+    }
+
+    return crc;
+}
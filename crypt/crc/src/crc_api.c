@@ -8,6 +8,7 @@
  */
 
 #include "crc_api.h"
+#include <stdint.h>
 #include <string.h>
 
 /* ============================================================================
@@ -102,6 +103,18 @@ static const crc_entry_t crc_table[] = {
 
 #define CRC_TABLE_SIZE (sizeof(crc_table) / sizeof(crc_table[0]))
 
+/**
+ * @brief 算法别名（不单独占用配置表项）
+ *
+ * Zephyr 的 crc16_ccitt() 是反向 0x1021 的实现，seed 取 0 时与 KERMIT 完全一致。
+ */
+static const struct {
+    const char *name;
+    crc_type_t type;
+} crc_alias_table[] = {
+    { "ZEPHYR-CCITT", CRC_ZEPHYR_CCITT },
+};
+
 /* ============================================================================
  * 内部查找函数
  * ============================================================================ */
@@ -122,6 +135,101 @@ static const crc_entry_t *_find_entry(crc_type_t type)
     return NULL;
 }
 
+/**
+ * @brief 获取配置宽度对应的掩码
+ */
+static inline uint64_t _width_mask(const crc_config_t *config)
+{
+    return (config->width_bits == 64) ? UINT64_MAX : ((1ULL << config->width_bits) - 1);
+}
+
+/**
+ * @brief 初始寄存器值（与 crc_calc 相同的"首尾异或"处理）
+ */
+static inline uint64_t _init_register(const crc_config_t *config)
+{
+    uint64_t crc = config->init_crc;
+    if (config->xor_out != 0) {
+        crc ^= config->xor_out;
+    }
+    return crc & _width_mask(config);
+}
+
+#if CRC_USE_SLICING
+
+/** @brief crc_compute_many() 交错计算的路数 */
+#define CRC_MANY_LANES CRC32C_LANES
+
+/**
+ * @brief 按数据长度选择最快内核更新寄存器（结果与 crc_update 一致）
+ *
+ * @param hw32c 配置为CRC-32C且CPU支持SSE4.2
+ * @param table 短数据使用的字节表，为NULL时短数据逐位计算
+ */
+static uint64_t _update_fast(const uint8_t *data, size_t len, uint64_t crc,
+                             const crc_config_t *config, int hw32c,
+                             const uint64_t *table)
+{
+    /* CRC-32C：crc32指令对短数据（如CAN帧）同样最快 */
+    if (hw32c) {
+        return crc32c_update_hw(data, len, (uint32_t)crc);
+    }
+
+    if (len >= CRC_CLMUL_MIN_LEN && crc_clmul_available()) {
+        const crc_clmul_t *clmul = crc_clmul_get(config);
+        if (clmul != NULL) {
+            return crc_update_clmul(data, len, crc, clmul);
+        }
+    }
+
+    if (len >= CRC_SLICE_MIN_LEN) {
+        const crc_slice_table_t *slice = crc_slice_get(config);
+        if (slice != NULL) {
+            return crc_update_slice16(data, len, crc, slice);
+        }
+    }
+
+    if (table != NULL) {
+        return crc_update_table(data, len, crc, table, config);
+    }
+    return crc_update(data, len, crc, config);
+}
+
+/**
+ * @brief 4路交错查表：各路依赖链相互独立，由CPU乱序执行并行推进
+ */
+static void _update_table_x4(const uint8_t *const p[CRC_MANY_LANES], size_t len,
+                             uint64_t reg[CRC_MANY_LANES], const uint64_t *table,
+                             const crc_config_t *config)
+{
+    uint64_t c0 = reg[0], c1 = reg[1], c2 = reg[2], c3 = reg[3];
+
+    if (config->reverse) {
+        for (size_t i = 0; i < len; i++) {
+            c0 = table[(c0 ^ p[0][i]) & 0xFF] ^ (c0 >> 8);
+            c1 = table[(c1 ^ p[1][i]) & 0xFF] ^ (c1 >> 8);
+            c2 = table[(c2 ^ p[2][i]) & 0xFF] ^ (c2 >> 8);
+            c3 = table[(c3 ^ p[3][i]) & 0xFF] ^ (c3 >> 8);
+        }
+    } else {
+        const uint8_t shift = config->width_bits - 8;
+        const uint64_t mask = _width_mask(config);
+        for (size_t i = 0; i < len; i++) {
+            c0 = (table[((c0 >> shift) ^ p[0][i]) & 0xFF] ^ (c0 << 8)) & mask;
+            c1 = (table[((c1 >> shift) ^ p[1][i]) & 0xFF] ^ (c1 << 8)) & mask;
+            c2 = (table[((c2 >> shift) ^ p[2][i]) & 0xFF] ^ (c2 << 8)) & mask;
+            c3 = (table[((c3 >> shift) ^ p[3][i]) & 0xFF] ^ (c3 << 8)) & mask;
+        }
+    }
+
+    reg[0] = c0;
+    reg[1] = c1;
+    reg[2] = c2;
+    reg[3] = c3;
+}
+
+#endif /* CRC_USE_SLICING */
+
 /* ============================================================================
  * 公共接口实现
  * ============================================================================ */
@@ -155,15 +263,180 @@ const char *crc_get_name(crc_type_t type)
     return entry->name;
 }
 
+/**
+ * @brief 名称字符归一化：转为小写
+ */
+static inline char _name_char(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+static inline int _name_sep(char c)
+{
+    return c == '-' || c == '_';
+}
+
+/**
+ * @brief 比较名称：不区分大小写，忽略 '-' 和 '_'
+ */
+static int _name_equal(const char *a, const char *b)
+{
+    for (;;) {
+        while (_name_sep(*a)) {
+            a++;
+        }
+        while (_name_sep(*b)) {
+            b++;
+        }
+        if (*a == '\0' || *b == '\0') {
+            return *a == *b;
+        }
+        if (_name_char(*a++) != _name_char(*b++)) {
+            return 0;
+        }
+    }
+}
+
+/**
+ * @brief 去掉 "CRC-"/"CRC_" 前缀（不区分大小写），无前缀时返回NULL
+ */
+static const char *_skip_crc_prefix(const char *name)
+{
+    if (_name_char(name[0]) != 'c' || _name_char(name[1]) != 'r' ||
+        _name_char(name[2]) != 'c' || !_name_sep(name[3])) {
+        return NULL;
+    }
+    return name + 4;
+}
+
+int crc_get_type_by_name(const char *name, crc_type_t *type)
+{
+    if (name == NULL || type == NULL) {
+        return -1;
+    }
+
+    const char *bare = _skip_crc_prefix(name);
+
+    for (size_t i = 0; i < CRC_TABLE_SIZE; i++) {
+        const char *entry = crc_table[i].name;
+        const char *entry_bare = _skip_crc_prefix(entry);
+
+        /* 精确匹配；或一方带 "CRC-" 前缀而另一方没有（如 CRC_MODBUS 与 MODBUS） */
+        if (_name_equal(name, entry) ||
+            (bare != NULL && entry_bare == NULL && _name_equal(bare, entry)) ||
+            (bare == NULL && entry_bare != NULL && _name_equal(name, entry_bare))) {
+            *type = crc_table[i].type;
+            return 0;
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(crc_alias_table) / sizeof(crc_alias_table[0]); i++) {
+        const char *alias = crc_alias_table[i].name;
+        if (_name_equal(name, alias) || (bare != NULL && _name_equal(bare, alias))) {
+            *type = crc_alias_table[i].type;
+            return 0;
+        }
+    }
+    return -1;
+}
+
 uint64_t crc_compute(crc_type_t type, const uint8_t *data, size_t len)
 {
     const crc_entry_t *entry = _find_entry(type);
     if (entry == NULL) {
         return 0;
     }
+
+#if CRC_USE_SLICING
+    const crc_config_t *config = &entry->config;
+    const int hw32c = crc32c_config_match(config) && crc32c_hw_available();
+
+    if (data != NULL && (hw32c || len >= CRC_SLICE_MIN_LEN)) {
+        uint64_t crc = _update_fast(data, len, _init_register(config), config, hw32c, NULL);
+        return crc_finalize(crc, config);
+    }
+#endif
+
     return crc_calc(data, len, &entry->config);
 }
 
+/**
+ * @设计说明：
+ * 每组4个缓冲区先交错计算公共长度部分（CRC-32C使用4路crc32指令，
+ * 其他算法使用共享字节表的4路查表），各自剩余部分再按长度选择内核。
+ * 公共长度不小于 CRC_SLICE_MIN_LEN 时交错查表不如slicing/折叠内核，改为逐个计算。
+ */
+int crc_compute_many(crc_type_t type, const uint8_t *const *bufs, const size_t *lens,
+                     uint64_t *out, size_t n)
+{
+    const crc_entry_t *entry = _find_entry(type);
+    if (entry == NULL || (n > 0 && (bufs == NULL || lens == NULL || out == NULL))) {
+        return -1;
+    }
+
+    const crc_config_t *config = &entry->config;
+    const uint64_t init = _init_register(config);
+    size_t i = 0;
+
+#if CRC_USE_SLICING
+    const int hw32c = crc32c_config_match(config) && crc32c_hw_available();
+    const crc_clmul_t *shared = hw32c ? NULL : crc_clmul_get(config);
+    const uint64_t *table = (shared != NULL) ? shared->table : NULL;
+
+    for (; i + CRC_MANY_LANES <= n; i += CRC_MANY_LANES) {
+        const uint8_t *p[CRC_MANY_LANES];
+        uint64_t reg[CRC_MANY_LANES];
+        size_t common = SIZE_MAX;
+
+        for (int k = 0; k < CRC_MANY_LANES; k++) {
+            p[k] = bufs[i + k];
+            reg[k] = init;
+            if (p[k] == NULL || lens[i + k] < common) {
+                common = (p[k] == NULL) ? 0 : lens[i + k];
+            }
+        }
+        if (!hw32c && (table == NULL || common >= CRC_SLICE_MIN_LEN)) {
+            common = 0;
+        }
+
+        if (common > 0 && hw32c) {
+            uint32_t c32[CRC_MANY_LANES];
+            for (int k = 0; k < CRC_MANY_LANES; k++) {
+                c32[k] = (uint32_t)reg[k];
+            }
+            crc32c_update_hw_x4(p, common, c32);
+            for (int k = 0; k < CRC_MANY_LANES; k++) {
+                reg[k] = c32[k];
+            }
+        } else if (common > 0) {
+            _update_table_x4(p, common, reg, table, config);
+        }
+
+        for (int k = 0; k < CRC_MANY_LANES; k++) {
+            if (p[k] != NULL && lens[i + k] > common) {
+                reg[k] = _update_fast(p[k] + common, lens[i + k] - common, reg[k],
+                                      config, hw32c, table);
+            }
+            out[i + k] = crc_finalize(reg[k], config);
+        }
+    }
+
+    for (; i < n; i++) {
+        uint64_t reg = init;
+        if (bufs[i] != NULL) {
+            reg = _update_fast(bufs[i], lens[i], reg, config, hw32c, table);
+        }
+        out[i] = crc_finalize(reg, config);
+    }
+#else
+    for (; i < n; i++) {
+        out[i] = crc_finalize(crc_update(bufs[i], lens[i], init, config), config);
+    }
+#endif
+
+    return 0;
+}
+
 int crc_init(crc_ctx_t *ctx, crc_type_t type)
 {
     if (ctx == NULL) {
@@ -176,6 +449,10 @@ int crc_init(crc_ctx_t *ctx, crc_type_t type)
     }
 
     ctx->config = entry->config;
+    ctx->mode = CRC_MODE_BITWISE;
+    ctx->table_ready = 0;
+    ctx->slice = NULL;
+    ctx->clmul = NULL;
     /* 应用"首尾异或"逻辑以匹配 crc_calc 的行为 */
     if (ctx->config.xor_out != 0) {
         ctx->crc = ctx->config.xor_out ^ ctx->config.init_crc;
@@ -192,6 +469,10 @@ int crc_init_custom(crc_ctx_t *ctx, const crc_config_t *config)
     }
 
     ctx->config = *config;
+    ctx->mode = CRC_MODE_BITWISE;
+    ctx->table_ready = 0;
+    ctx->slice = NULL;
+    ctx->clmul = NULL;
     /* 应用"首尾异或"逻辑以匹配 crc_calc 的行为 */
     if (ctx->config.xor_out != 0) {
         ctx->crc = ctx->config.xor_out ^ ctx->config.init_crc;
@@ -201,13 +482,105 @@ int crc_init_custom(crc_ctx_t *ctx, const crc_config_t *config)
     return 0;
 }
 
+int crc_set_mode(crc_ctx_t *ctx, crc_mode_t mode)
+{
+    if (ctx == NULL) {
+        return -1;
+    }
+
+    switch (mode) {
+    case CRC_MODE_BITWISE:
+    case CRC_MODE_TABLE:
+    case CRC_MODE_AUTO:
+        break;
+    case CRC_MODE_SLICE8:
+    case CRC_MODE_SLICE16:
+        if (!crc_slice_supported(&ctx->config)) {
+            return -1;
+        }
+        break;
+    case CRC_MODE_SSE42:
+        if (!crc32c_config_match(&ctx->config)) {
+            return -1;
+        }
+        break;
+    case CRC_MODE_CLMUL:
+        if (ctx->clmul == NULL) {
+            ctx->clmul = crc_clmul_get(&ctx->config);
+        }
+        if (ctx->clmul == NULL) {
+            return -1;
+        }
+        break;
+    default:
+        return -1;
+    }
+
+    ctx->mode = mode;
+    return 0;
+}
+
 int crc_update_ctx(crc_ctx_t *ctx, const uint8_t *data, size_t len)
 {
     if (ctx == NULL || data == NULL) {
         return -1;
     }
 
-    ctx->crc = crc_update(data, len, ctx->crc, &ctx->config);
+    crc_mode_t mode = ctx->mode;
+
+    /* 自动模式下CRC-32C优先使用crc32指令 */
+    if (mode == CRC_MODE_AUTO && CRC_USE_SLICING &&
+        crc32c_config_match(&ctx->config) && crc32c_hw_available()) {
+        mode = CRC_MODE_SSE42;
+    }
+
+    if (mode == CRC_MODE_SSE42) {
+        ctx->crc = crc32c_update_hw(data, len, (uint32_t)ctx->crc);
+        return 0;
+    }
+
+    /* 自动模式下的大块数据优先使用折叠内核 */
+    if (mode == CRC_MODE_AUTO && CRC_USE_SLICING &&
+        len >= CRC_CLMUL_MIN_LEN && crc_clmul_available()) {
+        if (ctx->clmul == NULL) {
+            ctx->clmul = crc_clmul_get(&ctx->config);
+        }
+        if (ctx->clmul != NULL) {
+            mode = CRC_MODE_CLMUL;
+        }
+    }
+
+    if (mode == CRC_MODE_CLMUL) {
+        ctx->crc = crc_update_clmul(data, len, ctx->crc, ctx->clmul);
+        return 0;
+    }
+
+    /* slicing模式：延迟获取共享表，获取失败（缓存满/内存不足）时退化为字节表 */
+    if (mode == CRC_MODE_SLICE8 || mode == CRC_MODE_SLICE16 ||
+        (mode == CRC_MODE_AUTO && CRC_USE_SLICING && crc_slice_supported(&ctx->config))) {
+        if (ctx->slice == NULL) {
+            ctx->slice = crc_slice_get(&ctx->config);
+        }
+        if (ctx->slice != NULL) {
+            uint64_t crc = ctx->crc & _width_mask(&ctx->config);
+            ctx->crc = (mode == CRC_MODE_SLICE8) ?
+                crc_update_slice8(data, len, crc, ctx->slice) :
+                crc_update_slice16(data, len, crc, ctx->slice);
+            return 0;
+        }
+        mode = CRC_MODE_TABLE;
+    }
+
+    if (mode == CRC_MODE_TABLE || (mode == CRC_MODE_AUTO && CRC_USE_SLICING)) {
+        /* 延迟生成表，只使用逐位模式的上下文不付出生成开销 */
+        if (!ctx->table_ready) {
+            crc_table_init(ctx->table, &ctx->config);
+            ctx->table_ready = 1;
+        }
+        ctx->crc = crc_update_table(data, len, ctx->crc, ctx->table, &ctx->config);
+    } else {
+        ctx->crc = crc_update(data, len, ctx->crc, &ctx->config);
+    }
     return 0;
 }
 
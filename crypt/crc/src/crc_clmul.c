@@ -0,0 +1,273 @@
+/**
+ * @file crc_clmul.c
+ * @brief 无进位乘法（PCLMULQDQ）折叠CRC内核实现
+ *
+ * @date 2026-10-18
+ * @license MIT
+ */
+
+#include "crc_clmul.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CRC_CLMUL_X86 1
+#include <immintrin.h>
+#else
+#define CRC_CLMUL_X86 0
+#endif
+
+/* ============================================================================
+ * 私有定义
+ * ============================================================================ */
+
+/** @brief 共享上下文缓存槽位数 */
+#define CRC_CLMUL_CACHE_SLOTS 32
+
+/** @brief 共享上下文缓存，槽位一经发布不再修改 */
+static _Atomic(crc_clmul_t *) clmul_cache[CRC_CLMUL_CACHE_SLOTS];
+
+/* ============================================================================
+ * 私有辅助函数
+ * ============================================================================ */
+
+/**
+ * @brief 计算 x^k mod P（前向表示，结果次数小于width）
+ */
+static uint64_t _xpow_mod(uint32_t k, const crc_config_t *config)
+{
+    const uint8_t width = config->width_bits;
+    const uint64_t mask = (width == 64) ? UINT64_MAX : ((1ULL << width) - 1);
+    const uint64_t poly = config->poly & mask;
+    uint64_t r = 1;
+
+    for (uint32_t i = 0; i < k; i++) {
+        uint64_t carry = (r >> (width - 1)) & 1;
+        r = (r << 1) & mask;
+        if (carry) {
+            r ^= poly;
+        }
+    }
+    return r;
+}
+
+/**
+ * @brief 生成折叠距离为d位的常数对
+ *
+ * @param k 输出常数对，k[0]与累加器低64位相乘，k[1]与高64位相乘
+ * @param d 折叠距离（位）
+ * @param config CRC配置参数
+ *
+ * @说明：
+ * - 前向算法：按大端加载，寄存器第p位即次数p，
+ *   k[0] = x^d mod P, k[1] = x^(d+64) mod P
+ * - 反向算法：按小端加载，寄存器第p位为次数127-p，两个反射操作数的乘积
+ *   比反射后的乘积少左移1位，因此使用 x^(d+63) 和 x^(d-1) 的64位位反转
+ */
+static void _fold_keys(uint64_t k[2], uint32_t d, const crc_config_t *config)
+{
+    if (config->reverse) {
+        k[0] = bit_reverse64(_xpow_mod(d + 63, config));
+        k[1] = bit_reverse64(_xpow_mod(d - 1, config));
+    } else {
+        k[0] = _xpow_mod(d, config);
+        k[1] = _xpow_mod(d + 64, config);
+    }
+}
+
+static int _same_key(const crc_config_t *a, const crc_config_t *b)
+{
+    return a->poly == b->poly &&
+           a->width_bits == b->width_bits &&
+           (a->reverse != 0) == (b->reverse != 0);
+}
+
+static int _clmul_supported_config(const crc_config_t *config)
+{
+    return config != NULL &&
+           config->width_bits >= 8 && config->width_bits <= 64 &&
+           (config->width_bits % 8) == 0;
+}
+
+#if CRC_CLMUL_X86
+
+/**
+ * @brief 折叠：acc * x^d + next（模P同余）
+ */
+__attribute__((target("pclmul,ssse3")))
+static inline __m128i _fold(__m128i acc, __m128i keys, __m128i next)
+{
+    __m128i lo = _mm_clmulepi64_si128(acc, keys, 0x00);
+    __m128i hi = _mm_clmulepi64_si128(acc, keys, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(lo, hi), next);
+}
+
+__attribute__((target("pclmul,ssse3")))
+static inline __m128i _load(const uint8_t *p, int reverse, __m128i bswap)
+{
+    __m128i x = _mm_loadu_si128((const __m128i *)p);
+    return reverse ? x : _mm_shuffle_epi8(x, bswap);
+}
+
+/**
+ * @brief 折叠主流程
+ *
+ * 1. 将当前CRC异或到数据首部（前向按大端、反向按小端对齐），此后以初值0计算
+ * 2. 4路累加器每次各折叠512位，合并为1路后再逐16字节折叠
+ * 3. 最终128位累加器按原字节序写回，与剩余尾部一起经字节表得到CRC
+ */
+__attribute__((target("pclmul,ssse3")))
+static uint64_t _update_clmul_x86(const uint8_t *data, size_t len, uint64_t crc,
+                                  const crc_clmul_t *ctx)
+{
+    const crc_config_t *cfg = &ctx->config;
+    const int reverse = cfg->reverse != 0;
+    const uint8_t nbytes = cfg->width_bits / 8;
+    const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                       8, 9, 10, 11, 12, 13, 14, 15);
+    uint8_t head[16];
+    __m128i acc;
+
+    memcpy(head, data, 16);
+    for (uint8_t i = 0; i < nbytes; i++) {
+        head[i] ^= reverse ? (uint8_t)(crc >> (8 * i))
+                           : (uint8_t)(crc >> (cfg->width_bits - 8 - 8 * i));
+    }
+
+    if (len >= 128) {
+        const __m128i k512 = _mm_loadu_si128((const __m128i *)ctx->k512);
+        __m128i a0 = _load(head, reverse, bswap);
+        __m128i a1 = _load(data + 16, reverse, bswap);
+        __m128i a2 = _load(data + 32, reverse, bswap);
+        __m128i a3 = _load(data + 48, reverse, bswap);
+
+        data += 64;
+        len -= 64;
+        for (; len >= 64; data += 64, len -= 64) {
+            a0 = _fold(a0, k512, _load(data, reverse, bswap));
+            a1 = _fold(a1, k512, _load(data + 16, reverse, bswap));
+            a2 = _fold(a2, k512, _load(data + 32, reverse, bswap));
+            a3 = _fold(a3, k512, _load(data + 48, reverse, bswap));
+        }
+
+        acc = _fold(a0, _mm_loadu_si128((const __m128i *)ctx->k384), a3);
+        acc = _fold(a1, _mm_loadu_si128((const __m128i *)ctx->k256), acc);
+        acc = _fold(a2, _mm_loadu_si128((const __m128i *)ctx->k128), acc);
+    } else {
+        acc = _load(head, reverse, bswap);
+        data += 16;
+        len -= 16;
+    }
+
+    const __m128i k128 = _mm_loadu_si128((const __m128i *)ctx->k128);
+    for (; len >= 16; data += 16, len -= 16) {
+        acc = _fold(acc, k128, _load(data, reverse, bswap));
+    }
+
+    if (!reverse) {
+        acc = _mm_shuffle_epi8(acc, bswap);
+    }
+    _mm_storeu_si128((__m128i *)head, acc);
+
+    crc = crc_update_table(head, 16, 0, ctx->table, cfg);
+    return crc_update_table(data, len, crc, ctx->table, cfg);
+}
+
+#endif /* CRC_CLMUL_X86 */
+
+/* ============================================================================
+ * 公共接口实现
+ * ============================================================================ */
+
+int crc_clmul_available(void)
+{
+#if CRC_CLMUL_X86
+    static atomic_int available = -1;
+    int v = atomic_load_explicit(&available, memory_order_relaxed);
+
+    if (v < 0) {
+        __builtin_cpu_init();
+        v = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+        atomic_store_explicit(&available, v, memory_order_relaxed);
+    }
+    return v;
+#else
+    return 0;
+#endif
+}
+
+int crc_clmul_init(crc_clmul_t *ctx, const crc_config_t *config)
+{
+    if (ctx == NULL || !_clmul_supported_config(config)) {
+        return -1;
+    }
+
+    ctx->config = *config;
+    _fold_keys(ctx->k512, 512, config);
+    _fold_keys(ctx->k384, 384, config);
+    _fold_keys(ctx->k256, 256, config);
+    _fold_keys(ctx->k128, 128, config);
+    crc_table_init(ctx->table, config);
+
+    return 0;
+}
+
+const crc_clmul_t *crc_clmul_get(const crc_config_t *config)
+{
+    if (!_clmul_supported_config(config)) {
+        return NULL;
+    }
+
+    for (int i = 0; i < CRC_CLMUL_CACHE_SLOTS; i++) {
+        crc_clmul_t *cur = atomic_load_explicit(&clmul_cache[i], memory_order_acquire);
+
+        if (cur != NULL) {
+            if (_same_key(&cur->config, config)) {
+                return cur;
+            }
+            continue;
+        }
+
+        /* 空槽：生成并尝试发布，竞争失败时继续检查胜出者 */
+        crc_clmul_t *ctx = malloc(sizeof(*ctx));
+        if (ctx == NULL) {
+            return NULL;
+        }
+        crc_clmul_init(ctx, config);
+
+        crc_clmul_t *expected = NULL;
+        if (atomic_compare_exchange_strong_explicit(&clmul_cache[i], &expected, ctx,
+                                                    memory_order_acq_rel,
+                                                    memory_order_acquire)) {
+            return ctx;
+        }
+        free(ctx);
+        if (_same_key(&expected->config, config)) {
+            return expected;
+        }
+    }
+
+    return NULL;
+}
+
+uint64_t crc_update_clmul(const uint8_t *data, size_t len, uint64_t crc,
+                          const crc_clmul_t *ctx)
+{
+    if (data == NULL || ctx == NULL) {
+        return crc;
+    }
+
+    const uint64_t mask = (ctx->config.width_bits == 64) ?
+                          UINT64_MAX : ((1ULL << ctx->config.width_bits) - 1);
+    crc &= mask;
+
+#if CRC_CLMUL_X86
+    /* 至少两个16字节块才值得折叠 */
+    if (len >= 32 && crc_clmul_available()) {
+        return _update_clmul_x86(data, len, crc, ctx);
+    }
+#endif
+
+    return crc_update_table(data, len, crc, ctx->table, &ctx->config);
+}
@@ -0,0 +1,142 @@
+/**
+ * @file crc_combine.c
+ * @brief CRC合并与零字节/填充字节扩展运算实现
+ *
+ * @date 2026-10-18
+ * @license MIT
+ */
+
+#include "crc_combine.h"
+
+/* ============================================================================
+ * 私有辅助函数
+ * ============================================================================ */
+
+static inline uint64_t _width_mask(uint8_t width_bits)
+{
+    return (width_bits == 64) ? UINT64_MAX : ((1ULL << width_bits) - 1);
+}
+
+/**
+ * @brief GF(2)矩阵乘向量
+ *
+ * 矩阵按列存放：mat[i] 为寄存器第i位为1时的变换结果
+ */
+static uint64_t _mat_apply(const uint64_t mat[CRC_MAX_BITS], uint64_t vec)
+{
+    uint64_t r = 0;
+
+    for (int i = 0; vec != 0; i++, vec >>= 1) {
+        if (vec & 1) {
+            r ^= mat[i];
+        }
+    }
+    return r;
+}
+
+/**
+ * @brief 矩阵平方：sq = mat · mat
+ */
+static void _mat_square(uint64_t sq[CRC_MAX_BITS], const uint64_t mat[CRC_MAX_BITS],
+                        uint8_t width_bits)
+{
+    for (uint8_t i = 0; i < width_bits; i++) {
+        sq[i] = _mat_apply(mat, mat[i]);
+    }
+}
+
+/**
+ * @brief 最终CRC还原为寄存器值（crc_finalize 的逆运算）
+ */
+static uint64_t _unfinalize(uint64_t crc, const crc_config_t *config)
+{
+    const uint64_t mask = _width_mask(config->width_bits);
+
+    crc &= mask;
+    if (config->refout) {
+        crc = bit_reverse(crc, config->width_bits);
+    }
+    return (crc ^ config->xor_out) & mask;
+}
+
+/**
+ * @brief 寄存器追加n个fill字节
+ *
+ * @算法说明：
+ * 设 Z 为"追加1个零字节"矩阵（列由 crc_update() 处理单比特寄存器得到），
+ * V 为初值0时处理1个fill字节的寄存器，则追加k个fill字节为 r -> Z^k·r ^ V_k。
+ * 按n的二进制位从低到高：位为1时应用当前 (Z^k, V_k)，
+ * 然后倍增 V_2k = Z^k·V_k ^ V_k，Z^2k = Z^k·Z^k。
+ * 所有分块内容相同，应用顺序不影响结果。
+ */
+static uint64_t _append(uint64_t reg, uint64_t n, uint8_t fill, const crc_config_t *config)
+{
+    const uint8_t width = config->width_bits;
+    const uint8_t zero = 0;
+    uint64_t buf_a[CRC_MAX_BITS], buf_b[CRC_MAX_BITS];
+    uint64_t *mat = buf_a, *tmp = buf_b;
+
+    for (uint8_t i = 0; i < width; i++) {
+        mat[i] = crc_update(&zero, 1, 1ULL << i, config);
+    }
+    uint64_t v = crc_update(&fill, 1, 0, config);
+
+    while (n != 0) {
+        if (n & 1) {
+            reg = _mat_apply(mat, reg) ^ v;
+        }
+        n >>= 1;
+        if (n == 0) {
+            break;
+        }
+        v = _mat_apply(mat, v) ^ v;
+        _mat_square(tmp, mat, width);
+
+        uint64_t *swap = mat;
+        mat = tmp;
+        tmp = swap;
+    }
+
+    return reg;
+}
+
+/* ============================================================================
+ * 公共接口实现
+ * ============================================================================ */
+
+/**
+ * @设计说明：
+ * 记初始寄存器 s0 = init_crc ^ xor_out（与 crc_calc 的"首尾异或"一致），
+ * 则 reg(B) = Z^|B|·s0 ^ R0(B)，reg(A||B) = Z^|B|·reg(A) ^ R0(B)，
+ * 因此 reg(A||B) = Z^|B|·(reg(A) ^ s0) ^ reg(B)。
+ */
+uint64_t crc_combine(uint64_t crc_a, uint64_t crc_b, uint64_t len_b,
+                     const crc_config_t *config)
+{
+    if (config == NULL) {
+        return 0;
+    }
+
+    const uint64_t mask = _width_mask(config->width_bits);
+    const uint64_t s0 = (config->init_crc ^ config->xor_out) & mask;
+    uint64_t reg = _unfinalize(crc_a, config) ^ s0;
+
+    reg = _append(reg, len_b, 0, config) ^ _unfinalize(crc_b, config);
+    return crc_finalize(reg, config);
+}
+
+uint64_t crc_append_fill(uint64_t crc, uint64_t n, uint8_t fill,
+                         const crc_config_t *config)
+{
+    if (config == NULL) {
+        return 0;
+    }
+
+    uint64_t reg = _append(_unfinalize(crc, config), n, fill, config);
+    return crc_finalize(reg, config);
+}
+
+uint64_t crc_append_zeros(uint64_t crc, uint64_t n, const crc_config_t *config)
+{
+    return crc_append_fill(crc, n, 0x00, config);
+}
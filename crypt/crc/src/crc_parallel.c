@@ -0,0 +1,130 @@
+/**
+ * @file crc_parallel.c
+ * @brief 多线程大块数据CRC计算
+ *
+ * 数据按线程数切分，各线程用 crc_compute() 计算分块CRC，
+ * 再由 crc_combine() 依次合并。使用C11 <threads.h>，
+ * 平台不提供时退化为单线程计算。
+ *
+ * @date 2026-10-18
+ * @license MIT
+ */
+
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#include <unistd.h>
+#endif
+
+#include "crc_api.h"
+
+/* MinGW等工具链未定义 __STDC_NO_THREADS__ 但也不提供 <threads.h> */
+#if !defined(__STDC_NO_THREADS__) && defined(__has_include)
+#if __has_include(<threads.h>)
+#define CRC_HAVE_THREADS 1
+#include <threads.h>
+#endif
+#endif
+
+#ifndef CRC_HAVE_THREADS
+#define CRC_HAVE_THREADS 0
+#endif
+
+/* ============================================================================
+ * 私有定义
+ * ============================================================================ */
+
+/** @brief 未能获取CPU核数时使用的线程数 */
+#define CRC_PARALLEL_DEFAULT_THREADS 4
+
+/** @brief 分块CRC计算任务 */
+typedef struct {
+    crc_type_t type;
+    const uint8_t *data;
+    size_t len;
+    uint64_t crc;
+} crc_chunk_t;
+
+/* ============================================================================
+ * 私有辅助函数
+ * ============================================================================ */
+
+static unsigned _cpu_count(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n > 0) {
+        return (unsigned)n;
+    }
+#endif
+    return CRC_PARALLEL_DEFAULT_THREADS;
+}
+
+#if CRC_HAVE_THREADS
+static int _chunk_worker(void *arg)
+{
+    crc_chunk_t *chunk = arg;
+    chunk->crc = crc_compute(chunk->type, chunk->data, chunk->len);
+    return 0;
+}
+#endif
+
+/* ============================================================================
+ * 公共接口实现
+ * ============================================================================ */
+
+uint64_t crc_compute_parallel(crc_type_t type, const uint8_t *data, size_t len,
+                              unsigned threads)
+{
+    crc_config_t config;
+
+    if (crc_get_config(type, &config) != 0) {
+        return 0;
+    }
+
+    if (threads == 0) {
+        threads = _cpu_count();
+    }
+    if (threads > CRC_PARALLEL_MAX_THREADS) {
+        threads = CRC_PARALLEL_MAX_THREADS;
+    }
+    if (data != NULL && len / CRC_PARALLEL_MIN_CHUNK < threads) {
+        threads = (unsigned)(len / CRC_PARALLEL_MIN_CHUNK);
+    }
+
+#if CRC_HAVE_THREADS
+    if (data == NULL || threads < 2) {
+        return crc_compute(type, data, len);
+    }
+
+    crc_chunk_t chunks[CRC_PARALLEL_MAX_THREADS];
+    thrd_t tids[CRC_PARALLEL_MAX_THREADS];
+    int started[CRC_PARALLEL_MAX_THREADS];
+    const size_t step = len / threads;
+
+    for (unsigned i = 0; i < threads; i++) {
+        chunks[i].type = type;
+        chunks[i].data = data + (size_t)i * step;
+        chunks[i].len = (i == threads - 1) ? len - (size_t)i * step : step;
+    }
+
+    /* 第0块由调用线程计算；线程创建失败的分块同样在调用线程补算 */
+    for (unsigned i = 1; i < threads; i++) {
+        started[i] = (thrd_create(&tids[i], _chunk_worker, &chunks[i]) == thrd_success);
+    }
+    _chunk_worker(&chunks[0]);
+
+    uint64_t crc = chunks[0].crc;
+    for (unsigned i = 1; i < threads; i++) {
+        if (started[i]) {
+            thrd_join(tids[i], NULL);
+        } else {
+            _chunk_worker(&chunks[i]);
+        }
+        crc = crc_combine(crc, chunks[i].crc, chunks[i].len, &config);
+    }
+    return crc;
+#else
+    (void)threads;
+    return crc_compute(type, data, len);
+#endif
+}
@@ -0,0 +1,280 @@
+/**
+ * @file crc_slice.c
+ * @brief Slicing-by-8/16 CRC内核实现
+ *
+ * @date 2026-10-18
+ * @license MIT
+ */
+
+#include "crc_slice.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * 私有定义
+ * ============================================================================ */
+
+/** @brief 共享表缓存槽位数（预定义的32/64位算法共约10种不同多项式） */
+#define CRC_SLICE_CACHE_SLOTS 32
+
+/** @brief 共享表缓存，槽位一经发布不再修改 */
+static _Atomic(crc_slice_table_t *) slice_cache[CRC_SLICE_CACHE_SLOTS];
+
+/* ============================================================================
+ * 私有辅助函数
+ * ============================================================================ */
+
+static inline uint32_t _load32_le(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint32_t _load32_be(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline uint64_t _load64_le(const uint8_t *p)
+{
+    return (uint64_t)_load32_le(p) | ((uint64_t)_load32_le(p + 4) << 32);
+}
+
+static inline uint64_t _load64_be(const uint8_t *p)
+{
+    return ((uint64_t)_load32_be(p) << 32) | (uint64_t)_load32_be(p + 4);
+}
+
+/**
+ * @brief 判断两个配置能否共用slicing表
+ *
+ * 表只取决于多项式、宽度和算法方向，初始值/输出异或不影响
+ */
+static int _same_table_key(const crc_config_t *a, const crc_config_t *b)
+{
+    return a->poly == b->poly &&
+           a->width_bits == b->width_bits &&
+           (a->reverse != 0) == (b->reverse != 0);
+}
+
+/* ----------------------------------------------------------------------------
+ * 单块内核：n为每块字节数（8或16），调用处为常量，编译器可完全展开
+ * 第j个字节之后还有n-1-j个字节，因此查表t[n-1-j]
+ * -------------------------------------------------------------------------- */
+
+static inline uint32_t _block_r32(const uint32_t (*t)[CRC_TABLE_ENTRIES],
+                                  const uint8_t *p, uint32_t crc, int n)
+{
+    uint32_t c = crc ^ _load32_le(p);
+    uint32_t r = t[n - 1][c & 0xFF] ^ t[n - 2][(c >> 8) & 0xFF] ^
+                 t[n - 3][(c >> 16) & 0xFF] ^ t[n - 4][c >> 24];
+
+    for (int j = 4; j < n; j++) {
+        r ^= t[n - 1 - j][p[j]];
+    }
+    return r;
+}
+
+static inline uint32_t _block_f32(const uint32_t (*t)[CRC_TABLE_ENTRIES],
+                                  const uint8_t *p, uint32_t crc, int n)
+{
+    uint32_t c = crc ^ _load32_be(p);
+    uint32_t r = t[n - 1][c >> 24] ^ t[n - 2][(c >> 16) & 0xFF] ^
+                 t[n - 3][(c >> 8) & 0xFF] ^ t[n - 4][c & 0xFF];
+
+    for (int j = 4; j < n; j++) {
+        r ^= t[n - 1 - j][p[j]];
+    }
+    return r;
+}
+
+static inline uint64_t _block_r64(const uint64_t (*t)[CRC_TABLE_ENTRIES],
+                                  const uint8_t *p, uint64_t crc, int n)
+{
+    uint64_t c = crc ^ _load64_le(p);
+    uint64_t r = 0;
+
+    for (int j = 0; j < 8; j++) {
+        r ^= t[n - 1 - j][(c >> (8 * j)) & 0xFF];
+    }
+    for (int j = 8; j < n; j++) {
+        r ^= t[n - 1 - j][p[j]];
+    }
+    return r;
+}
+
+static inline uint64_t _block_f64(const uint64_t (*t)[CRC_TABLE_ENTRIES],
+                                  const uint8_t *p, uint64_t crc, int n)
+{
+    uint64_t c = crc ^ _load64_be(p);
+    uint64_t r = 0;
+
+    for (int j = 0; j < 8; j++) {
+        r ^= t[n - 1 - j][(c >> (56 - 8 * j)) & 0xFF];
+    }
+    for (int j = 8; j < n; j++) {
+        r ^= t[n - 1 - j][p[j]];
+    }
+    return r;
+}
+
+/**
+ * @brief slicing主循环：先按n字节分块，剩余部分逐字节查t[0]
+ */
+static inline uint64_t _update_slice(const uint8_t *data, size_t len, uint64_t crc,
+                                     const crc_slice_table_t *tbl, int n)
+{
+    const crc_config_t *cfg = &tbl->config;
+
+    if (cfg->width_bits == 32) {
+        uint32_t c = (uint32_t)crc;
+
+        if (cfg->reverse) {
+            for (; len >= (size_t)n; data += n, len -= n) {
+                c = _block_r32(tbl->t32, data, c, n);
+            }
+            for (; len > 0; data++, len--) {
+                c = tbl->t32[0][(c ^ *data) & 0xFF] ^ (c >> 8);
+            }
+        } else {
+            for (; len >= (size_t)n; data += n, len -= n) {
+                c = _block_f32(tbl->t32, data, c, n);
+            }
+            for (; len > 0; data++, len--) {
+                c = tbl->t32[0][(c >> 24) ^ *data] ^ (c << 8);
+            }
+        }
+        return c;
+    }
+
+    if (cfg->reverse) {
+        for (; len >= (size_t)n; data += n, len -= n) {
+            crc = _block_r64(tbl->t64, data, crc, n);
+        }
+        for (; len > 0; data++, len--) {
+            crc = tbl->t64[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+        }
+    } else {
+        for (; len >= (size_t)n; data += n, len -= n) {
+            crc = _block_f64(tbl->t64, data, crc, n);
+        }
+        for (; len > 0; data++, len--) {
+            crc = tbl->t64[0][(crc >> 56) ^ *data] ^ (crc << 8);
+        }
+    }
+    return crc;
+}
+
+/* ============================================================================
+ * 公共接口实现
+ * ============================================================================ */
+
+int crc_slice_supported(const crc_config_t *config)
+{
+    return config != NULL && (config->width_bits == 32 || config->width_bits == 64);
+}
+
+/**
+ * @brief 按配置生成slicing表
+ *
+ * @算法说明：
+ * t[0]由crc_table_init()生成（即逐位算法对单字节的结果），
+ * t[k][i]为t[k-1][i]再推进一个零字节：
+ * - 反向算法: t[k][i] = (t[k-1][i] >> 8) ^ t[0][t[k-1][i] & 0xFF]
+ * - 前向算法: t[k][i] = (t[k-1][i] << 8) ^ t[0][t[k-1][i] >> (width - 8)]
+ */
+int crc_slice_init(crc_slice_table_t *tbl, const crc_config_t *config)
+{
+    uint64_t t0[CRC_TABLE_ENTRIES];
+
+    if (tbl == NULL || !crc_slice_supported(config)) {
+        return -1;
+    }
+
+    tbl->config = *config;
+    crc_table_init(t0, config);
+
+    if (config->width_bits == 32) {
+        for (int i = 0; i < CRC_TABLE_ENTRIES; i++) {
+            tbl->t32[0][i] = (uint32_t)t0[i];
+        }
+        for (int k = 1; k < CRC_SLICE_MAX; k++) {
+            for (int i = 0; i < CRC_TABLE_ENTRIES; i++) {
+                uint32_t x = tbl->t32[k - 1][i];
+                tbl->t32[k][i] = config->reverse ?
+                    (x >> 8) ^ tbl->t32[0][x & 0xFF] :
+                    (x << 8) ^ tbl->t32[0][x >> 24];
+            }
+        }
+    } else {
+        memcpy(tbl->t64[0], t0, sizeof(t0));
+        for (int k = 1; k < CRC_SLICE_MAX; k++) {
+            for (int i = 0; i < CRC_TABLE_ENTRIES; i++) {
+                uint64_t x = tbl->t64[k - 1][i];
+                tbl->t64[k][i] = config->reverse ?
+                    (x >> 8) ^ tbl->t64[0][x & 0xFF] :
+                    (x << 8) ^ tbl->t64[0][x >> 56];
+            }
+        }
+    }
+
+    return 0;
+}
+
+const crc_slice_table_t *crc_slice_get(const crc_config_t *config)
+{
+    if (!crc_slice_supported(config)) {
+        return NULL;
+    }
+
+    for (int i = 0; i < CRC_SLICE_CACHE_SLOTS; i++) {
+        crc_slice_table_t *cur = atomic_load_explicit(&slice_cache[i], memory_order_acquire);
+
+        if (cur != NULL) {
+            if (_same_table_key(&cur->config, config)) {
+                return cur;
+            }
+            continue;
+        }
+
+        /* 空槽：生成表并尝试发布，竞争失败时继续检查胜出者的表 */
+        crc_slice_table_t *tbl = malloc(sizeof(*tbl));
+        if (tbl == NULL) {
+            return NULL;
+        }
+        crc_slice_init(tbl, config);
+
+        crc_slice_table_t *expected = NULL;
+        if (atomic_compare_exchange_strong_explicit(&slice_cache[i], &expected, tbl,
+                                                    memory_order_acq_rel,
+                                                    memory_order_acquire)) {
+            return tbl;
+        }
+        free(tbl);
+        if (_same_table_key(&expected->config, config)) {
+            return expected;
+        }
+    }
+
+    return NULL;
+}
+
+uint64_t crc_update_slice8(const uint8_t *data, size_t len, uint64_t crc,
+                           const crc_slice_table_t *tbl)
+{
+    if (data == NULL || tbl == NULL) {
+        return crc;
+    }
+    return _update_slice(data, len, crc, tbl, 8);
+}
+
+uint64_t crc_update_slice16(const uint8_t *data, size_t len, uint64_t crc,
+                            const crc_slice_table_t *tbl)
+{
+    if (data == NULL || tbl == NULL) {
+        return crc;
+    }
+    return _update_slice(data, len, crc, tbl, 16);
+}
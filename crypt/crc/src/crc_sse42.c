@@ -0,0 +1,283 @@
+/**
+ * @file crc_sse42.c
+ * @brief CRC-32C SSE4.2 crc32指令快速路径实现
+ *
+ * @date 2026-10-18
+ * @license MIT
+ */
+
+#include "crc_sse42.h"
+#include "crc_slice.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define CRC_SSE42_X86 1
+#include <immintrin.h>
+#else
+#define CRC_SSE42_X86 0
+#endif
+
+/* ============================================================================
+ * 私有定义
+ * ============================================================================ */
+
+#define CRC32C_LONG  8192   /**< 长块三路并行时每路字节数 */
+#define CRC32C_SHORT 256    /**< 短块三路并行时每路字节数 */
+
+/**
+ * @brief 寄存器"追加n个零字节"的移位表
+ *
+ * 移位是GF(2)线性运算，按寄存器的4个字节分别查表后异或即可
+ */
+typedef struct {
+    uint32_t long_tbl[4][CRC_TABLE_ENTRIES];    /**< 追加CRC32C_LONG个零字节 */
+    uint32_t short_tbl[4][CRC_TABLE_ENTRIES];   /**< 追加CRC32C_SHORT个零字节 */
+} crc32c_shift_t;
+
+/** @brief CRC-32C寄存器运算配置（初值和输出异或由调用者处理） */
+static const crc_config_t crc32c_config = {
+    .poly = 0x1EDC6F41, .init_crc = 0, .xor_out = 0,
+    .width_bits = 32, .reverse = 1, .refin = 1, .refout = 0
+};
+
+static _Atomic(crc32c_shift_t *) shift_tables;
+
+/* ============================================================================
+ * 私有辅助函数
+ * ============================================================================ */
+
+/**
+ * @brief 生成追加n个零字节的移位表
+ *
+ * 先求32个单比特寄存器值经n个零字节后的结果，再按线性组合填表
+ */
+static void _build_shift(uint32_t tbl[4][CRC_TABLE_ENTRIES], size_t n,
+                         const crc_slice_table_t *slice)
+{
+    static const uint8_t zeros[CRC32C_LONG];
+    uint32_t basis[32];
+
+    for (int b = 0; b < 32; b++) {
+        basis[b] = (uint32_t)crc_update_slice8(zeros, n, 1ULL << b, slice);
+    }
+
+    for (int k = 0; k < 4; k++) {
+        for (int v = 0; v < CRC_TABLE_ENTRIES; v++) {
+            uint32_t r = 0;
+            for (int i = 0; i < 8; i++) {
+                if (v & (1 << i)) {
+                    r ^= basis[8 * k + i];
+                }
+            }
+            tbl[k][v] = r;
+        }
+    }
+}
+
+/**
+ * @brief 获取共享移位表，首次调用时生成并原子发布
+ */
+static const crc32c_shift_t *_get_shift(void)
+{
+    crc32c_shift_t *cur = atomic_load_explicit(&shift_tables, memory_order_acquire);
+    if (cur != NULL) {
+        return cur;
+    }
+
+    const crc_slice_table_t *slice = crc_slice_get(&crc32c_config);
+    if (slice == NULL) {
+        return NULL;
+    }
+
+    crc32c_shift_t *tbl = malloc(sizeof(*tbl));
+    if (tbl == NULL) {
+        return NULL;
+    }
+    _build_shift(tbl->long_tbl, CRC32C_LONG, slice);
+    _build_shift(tbl->short_tbl, CRC32C_SHORT, slice);
+
+    crc32c_shift_t *expected = NULL;
+    if (!atomic_compare_exchange_strong_explicit(&shift_tables, &expected, tbl,
+                                                 memory_order_acq_rel,
+                                                 memory_order_acquire)) {
+        free(tbl);
+        return expected;
+    }
+    return tbl;
+}
+
+static inline uint32_t _shift(const uint32_t tbl[4][CRC_TABLE_ENTRIES], uint32_t crc)
+{
+    return tbl[0][crc & 0xFF] ^ tbl[1][(crc >> 8) & 0xFF] ^
+           tbl[2][(crc >> 16) & 0xFF] ^ tbl[3][crc >> 24];
+}
+
+#if CRC_SSE42_X86
+
+static inline uint64_t _load64(const uint8_t *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief 三路并行处理 3*block 字节
+ *
+ * 三路相互独立，crc32指令的3周期延迟被流水线掩盖；
+ * 第1、2路结果经移位表依次合并到后续路上
+ */
+__attribute__((target("sse4.2")))
+static inline uint64_t _three_way(const uint8_t **pp, size_t block, uint64_t c0,
+                                  const uint32_t tbl[4][CRC_TABLE_ENTRIES])
+{
+    const uint8_t *p = *pp;
+    const uint8_t *end = p + block;
+    uint64_t c1 = 0, c2 = 0;
+
+    do {
+        c0 = _mm_crc32_u64(c0, _load64(p));
+        c1 = _mm_crc32_u64(c1, _load64(p + block));
+        c2 = _mm_crc32_u64(c2, _load64(p + 2 * block));
+        p += 8;
+    } while (p < end);
+
+    c0 = _shift(tbl, (uint32_t)c0) ^ c1;
+    c0 = _shift(tbl, (uint32_t)c0) ^ c2;
+
+    *pp = p + 2 * block;
+    return c0;
+}
+
+__attribute__((target("sse4.2")))
+static uint32_t _update_sse42(const uint8_t *p, size_t len, uint32_t crc,
+                              const crc32c_shift_t *shift)
+{
+    uint64_t c = crc;
+
+    /* 对齐到8字节 */
+    while (len > 0 && ((uintptr_t)p & 7) != 0) {
+        c = _mm_crc32_u8((uint32_t)c, *p++);
+        len--;
+    }
+
+    if (shift != NULL) {
+        for (; len >= 3 * CRC32C_LONG; len -= 3 * CRC32C_LONG) {
+            c = _three_way(&p, CRC32C_LONG, c, shift->long_tbl);
+        }
+        for (; len >= 3 * CRC32C_SHORT; len -= 3 * CRC32C_SHORT) {
+            c = _three_way(&p, CRC32C_SHORT, c, shift->short_tbl);
+        }
+    }
+
+    for (; len >= 8; p += 8, len -= 8) {
+        c = _mm_crc32_u64(c, _load64(p));
+    }
+    for (; len > 0; p++, len--) {
+        c = _mm_crc32_u8((uint32_t)c, *p);
+    }
+
+    return (uint32_t)c;
+}
+
+/**
+ * @brief 4路交错：每次迭代各处理8字节，尾部逐字节
+ */
+__attribute__((target("sse4.2")))
+static void _update_sse42_x4(const uint8_t *const p[CRC32C_LANES], size_t len,
+                             uint32_t crc[CRC32C_LANES])
+{
+    uint64_t c0 = crc[0], c1 = crc[1], c2 = crc[2], c3 = crc[3];
+    size_t i = 0;
+
+    for (; i + 8 <= len; i += 8) {
+        c0 = _mm_crc32_u64(c0, _load64(p[0] + i));
+        c1 = _mm_crc32_u64(c1, _load64(p[1] + i));
+        c2 = _mm_crc32_u64(c2, _load64(p[2] + i));
+        c3 = _mm_crc32_u64(c3, _load64(p[3] + i));
+    }
+    for (; i < len; i++) {
+        c0 = _mm_crc32_u8((uint32_t)c0, p[0][i]);
+        c1 = _mm_crc32_u8((uint32_t)c1, p[1][i]);
+        c2 = _mm_crc32_u8((uint32_t)c2, p[2][i]);
+        c3 = _mm_crc32_u8((uint32_t)c3, p[3][i]);
+    }
+
+    crc[0] = (uint32_t)c0;
+    crc[1] = (uint32_t)c1;
+    crc[2] = (uint32_t)c2;
+    crc[3] = (uint32_t)c3;
+}
+
+#endif /* CRC_SSE42_X86 */
+
+/* ============================================================================
+ * 公共接口实现
+ * ============================================================================ */
+
+int crc32c_hw_available(void)
+{
+#if CRC_SSE42_X86
+    static atomic_int available = -1;
+    int v = atomic_load_explicit(&available, memory_order_relaxed);
+
+    if (v < 0) {
+        __builtin_cpu_init();
+        v = __builtin_cpu_supports("sse4.2") != 0;
+        atomic_store_explicit(&available, v, memory_order_relaxed);
+    }
+    return v;
+#else
+    return 0;
+#endif
+}
+
+int crc32c_config_match(const crc_config_t *config)
+{
+    return config != NULL &&
+           config->width_bits == 32 &&
+           config->reverse != 0 &&
+           (config->poly & 0xFFFFFFFF) == crc32c_config.poly;
+}
+
+uint32_t crc32c_update_hw(const uint8_t *data, size_t len, uint32_t crc)
+{
+    if (data == NULL) {
+        return crc;
+    }
+
+#if CRC_SSE42_X86
+    if (crc32c_hw_available()) {
+        /* 短数据（如8字节CAN帧）不需要移位表 */
+        const crc32c_shift_t *shift = (len >= 3 * CRC32C_SHORT) ? _get_shift() : NULL;
+        return _update_sse42(data, len, crc, shift);
+    }
+#endif
+
+    const crc_slice_table_t *slice = crc_slice_get(&crc32c_config);
+    if (slice != NULL) {
+        return (uint32_t)crc_update_slice8(data, len, crc, slice);
+    }
+    return (uint32_t)crc_update(data, len, crc, &crc32c_config);
+}
+
+void crc32c_update_hw_x4(const uint8_t *const data[CRC32C_LANES], size_t len,
+                         uint32_t crc[CRC32C_LANES])
+{
+    if (data == NULL || crc == NULL) {
+        return;
+    }
+
+#if CRC_SSE42_X86
+    if (crc32c_hw_available()) {
+        _update_sse42_x4(data, len, crc);
+        return;
+    }
+#endif
+
+    for (int k = 0; k < CRC32C_LANES; k++) {
+        crc[k] = crc32c_update_hw(data[k], len, crc[k]);
+    }
+}
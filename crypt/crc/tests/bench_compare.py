@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""
+比较两次 bench_crc --json 的结果，标记吞吐回归
+
+用法:
+    python3 bench_compare.py baseline.json current.json [--threshold 0.10] [--min-size 64]
+
+对每个 (type, kernel, size) 计算 current / baseline，下降超过 threshold 的记为回归，
+存在回归时退出码为 1，供 CI 判定。小于 --min-size 的测量点计时噪声较大，默认忽略。
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+    return {(r["type"], r["kernel"], r["size"]): r["mb_per_s"] for r in data["results"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two bench_crc JSON results")
+    parser.add_argument("baseline", help="baseline JSON (e.g. from the previous commit)")
+    parser.add_argument("current", help="current JSON")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="relative slowdown that counts as a regression (default 0.10)")
+    parser.add_argument("--min-size", type=int, default=64,
+                        help="ignore buffer sizes below this many bytes (default 64)")
+    parser.add_argument("--all", action="store_true", help="print every compared point")
+    args = parser.parse_args()
+
+    base = load(args.baseline)
+    cur = load(args.current)
+
+    regressions = []
+    compared = 0
+    for key in sorted(base.keys() & cur.keys()):
+        if key[2] < args.min_size or base[key] <= 0:
+            continue
+        compared += 1
+        ratio = cur[key] / base[key]
+        if ratio < 1.0 - args.threshold:
+            regressions.append((key, base[key], cur[key], ratio))
+        elif args.all:
+            print(f"  ok   {key[0]:>16} {key[1]:>8} {key[2]:>10}  "
+                  f"{base[key]:10.1f} -> {cur[key]:10.1f} MB/s ({ratio:5.2f}x)")
+
+    for (ctype, kernel, size), b, c, ratio in regressions:
+        print(f"  SLOW {ctype:>16} {kernel:>8} {size:>10}  "
+              f"{b:10.1f} -> {c:10.1f} MB/s ({ratio:5.2f}x)")
+
+    missing = sorted(base.keys() - cur.keys())
+    for ctype, kernel, size in missing:
+        print(f"  MISSING {ctype} {kernel} {size}")
+
+    print(f"compared {compared} points, {len(regressions)} regression(s), "
+          f"{len(missing)} missing")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,427 @@
+/**
+ * @file bench_crc.c
+ * @brief CRC库吞吐基准
+ *
+ * 对每个预定义算法、每种可用内核（逐位、字节表、slicing-by-8/16、PCLMULQDQ折叠、
+ * SSE4.2 crc32指令、crc_compute()自动选择）按缓冲区大小（8字节到64MB）测量吞吐，
+ * 并比较8字节帧逐帧 crc_compute() 与批量 crc_compute_many() 的帧率。
+ * 每个测量点重复运行至少 --min-time 毫秒（大缓冲区至少运行1次），取平均值。
+ *
+ * 用法：
+ *   bench_crc [--json] [--output FILE] [--type NAME] [--kernel NAME]
+ *             [--max-size BYTES] [--min-time MS]
+ *
+ * --json 输出机器可读的JSON（tests/bench_compare.py 比较两次结果并标记回归），
+ * 否则输出文本表格。
+ *
+ * @date 2026-10-18
+ * @license MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "crc_api.h"
+
+/* ============================================================================
+ * 私有定义
+ * ============================================================================ */
+
+/** @brief 默认每个测量点的最短运行时间（毫秒） */
+#define BENCH_DEFAULT_MIN_MS 50
+
+/** @brief 最大缓冲区大小 */
+#define BENCH_MAX_SIZE (64u * 1024 * 1024)
+
+/** @brief 批量测试的帧数 */
+#define BENCH_FRAMES 4096
+
+/** @brief 批量测试的帧长（CAN帧数据） */
+#define BENCH_FRAME_LEN 8
+
+/** @brief 内核函数：返回更新后的寄存器值 */
+typedef uint64_t (*bench_fn_t)(const uint8_t *data, size_t len, uint64_t crc);
+
+/** @brief 内核描述 */
+typedef struct {
+    const char *name;
+    bench_fn_t fn;
+    int (*usable)(void);    /**< 当前算法/CPU能否使用该内核 */
+} bench_kernel_t;
+
+/** @brief 命令行选项 */
+typedef struct {
+    int json;
+    const char *output;
+    const char *type;
+    const char *kernel;
+    size_t max_size;
+    uint64_t min_ns;
+} bench_opts_t;
+
+/* 当前被测算法的共享状态 */
+static crc_type_t g_type;
+static crc_config_t g_config;
+static uint64_t g_table[CRC_TABLE_ENTRIES];
+static const crc_slice_table_t *g_slice;
+static const crc_clmul_t *g_clmul;
+
+/* 防止编译器消除计算结果 */
+static volatile uint64_t g_sink;
+
+/* ============================================================================
+ * 内核封装
+ * ============================================================================ */
+
+static int _always(void)
+{
+    return 1;
+}
+
+static int _slice_usable(void)
+{
+    return g_slice != NULL;
+}
+
+static int _clmul_usable(void)
+{
+    return g_clmul != NULL && crc_clmul_available();
+}
+
+static int _sse42_usable(void)
+{
+    return crc32c_config_match(&g_config) && crc32c_hw_available();
+}
+
+static uint64_t _bitwise(const uint8_t *data, size_t len, uint64_t crc)
+{
+    return crc_update(data, len, crc, &g_config);
+}
+
+static uint64_t _table(const uint8_t *data, size_t len, uint64_t crc)
+{
+    return crc_update_table(data, len, crc, g_table, &g_config);
+}
+
+static uint64_t _slice8(const uint8_t *data, size_t len, uint64_t crc)
+{
+    return crc_update_slice8(data, len, crc, g_slice);
+}
+
+static uint64_t _slice16(const uint8_t *data, size_t len, uint64_t crc)
+{
+    return crc_update_slice16(data, len, crc, g_slice);
+}
+
+static uint64_t _clmul(const uint8_t *data, size_t len, uint64_t crc)
+{
+    return crc_update_clmul(data, len, crc, g_clmul);
+}
+
+static uint64_t _sse42(const uint8_t *data, size_t len, uint64_t crc)
+{
+    return crc32c_update_hw(data, len, (uint32_t)crc);
+}
+
+static uint64_t _auto(const uint8_t *data, size_t len, uint64_t crc)
+{
+    return crc_compute(g_type, data, len) ^ crc;
+}
+
+static const bench_kernel_t kernels[] = {
+    { "bitwise", _bitwise, _always       },
+    { "table",   _table,   _always       },
+    { "slice8",  _slice8,  _slice_usable },
+    { "slice16", _slice16, _slice_usable },
+    { "clmul",   _clmul,   _clmul_usable },
+    { "sse42",   _sse42,   _sse42_usable },
+    { "auto",    _auto,    _always       },
+};
+
+#define KERNEL_COUNT (sizeof(kernels) / sizeof(kernels[0]))
+
+static const size_t sizes[] = {
+    8, 64, 512, 4096, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024, BENCH_MAX_SIZE
+};
+
+#define SIZE_COUNT (sizeof(sizes) / sizeof(sizes[0]))
+
+/* ============================================================================
+ * 计时
+ * ============================================================================ */
+
+static uint64_t _now_ns(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 测量单个内核在指定大小下的吞吐
+ *
+ * @return double MB/s
+ */
+static double _measure(bench_fn_t fn, const uint8_t *buf, size_t size, uint64_t min_ns)
+{
+    uint64_t crc = 0;
+    uint64_t iters = 0;
+    uint64_t batch = 1;
+    uint64_t start = _now_ns();
+    uint64_t elapsed;
+
+    /* 批量运行，避免短缓冲区时计时开销占主导 */
+    do {
+        for (uint64_t i = 0; i < batch; i++) {
+            crc = fn(buf, size, crc);
+        }
+        iters += batch;
+        if (batch < (1u << 20)) {
+            batch *= 2;
+        }
+        elapsed = _now_ns() - start;
+    } while (elapsed < min_ns);
+
+    g_sink = crc;
+    return (double)size * (double)iters * 1000.0 / (double)elapsed;
+}
+
+/**
+ * @brief 比较逐帧 crc_compute() 与 crc_compute_many() 的帧率
+ *
+ * @param rate 输出：[0] 逐帧, [1] 批量（百万帧/秒）
+ */
+static void _measure_many(crc_type_t type, const uint8_t *buf, uint64_t min_ns, double rate[2])
+{
+    static const uint8_t *bufs[BENCH_FRAMES];
+    static size_t lens[BENCH_FRAMES];
+    static uint64_t out[BENCH_FRAMES];
+    uint64_t iters = 0, start, elapsed;
+
+    for (size_t i = 0; i < BENCH_FRAMES; i++) {
+        bufs[i] = buf + i * BENCH_FRAME_LEN;
+        lens[i] = BENCH_FRAME_LEN;
+    }
+
+    start = _now_ns();
+    do {
+        for (size_t i = 0; i < BENCH_FRAMES; i++) {
+            out[i] = crc_compute(type, bufs[i], lens[i]);
+        }
+        iters++;
+        elapsed = _now_ns() - start;
+    } while (elapsed < min_ns);
+    rate[0] = (double)iters * BENCH_FRAMES * 1000.0 / (double)elapsed;
+
+    iters = 0;
+    start = _now_ns();
+    do {
+        crc_compute_many(type, bufs, lens, out, BENCH_FRAMES);
+        iters++;
+        elapsed = _now_ns() - start;
+    } while (elapsed < min_ns);
+    rate[1] = (double)iters * BENCH_FRAMES * 1000.0 / (double)elapsed;
+
+    g_sink = out[0];
+}
+
+/* ============================================================================
+ * 命令行
+ * ============================================================================ */
+
+static void _usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [--json] [--output FILE] [--type NAME] [--kernel NAME]\n"
+            "          [--max-size BYTES] [--min-time MS]\n"
+            "  --json           machine-readable JSON output\n"
+            "  --output FILE    write results to FILE instead of stdout\n"
+            "  --type NAME      only benchmark this algorithm (e.g. CRC-32C)\n"
+            "  --kernel NAME    bitwise|table|slice8|slice16|clmul|sse42|auto\n"
+            "  --max-size BYTES largest buffer size (default %u)\n"
+            "  --min-time MS    minimum run time per measurement (default %d)\n",
+            prog, BENCH_MAX_SIZE, BENCH_DEFAULT_MIN_MS);
+}
+
+static int _parse_args(int argc, char **argv, bench_opts_t *opts)
+{
+    opts->json = 0;
+    opts->output = NULL;
+    opts->type = NULL;
+    opts->kernel = NULL;
+    opts->max_size = BENCH_MAX_SIZE;
+    opts->min_ns = BENCH_DEFAULT_MIN_MS * 1000000ULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--json") == 0) {
+            opts->json = 1;
+            continue;
+        }
+        if (val == NULL) {
+            return -1;
+        }
+        if (strcmp(arg, "--output") == 0) {
+            opts->output = val;
+        } else if (strcmp(arg, "--type") == 0) {
+            opts->type = val;
+        } else if (strcmp(arg, "--kernel") == 0) {
+            opts->kernel = val;
+        } else if (strcmp(arg, "--max-size") == 0) {
+            opts->max_size = (size_t)strtoull(val, NULL, 0);
+        } else if (strcmp(arg, "--min-time") == 0) {
+            opts->min_ns = strtoull(val, NULL, 0) * 1000000ULL;
+        } else {
+            return -1;
+        }
+        i++;
+    }
+
+    if (opts->max_size > BENCH_MAX_SIZE) {
+        opts->max_size = BENCH_MAX_SIZE;
+    }
+    return 0;
+}
+
+/**
+ * @brief 切换被测算法，准备各内核使用的表
+ */
+static int _select_type(crc_type_t type)
+{
+    g_type = type;
+    if (crc_get_config(type, &g_config) != 0) {
+        return -1;
+    }
+    crc_table_init(g_table, &g_config);
+    g_slice = crc_slice_get(&g_config);
+    g_clmul = crc_clmul_get(&g_config);
+    return 0;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(int argc, char **argv)
+{
+    bench_opts_t opts;
+
+    if (_parse_args(argc, argv, &opts) != 0) {
+        _usage(argv[0]);
+        return 2;
+    }
+
+    FILE *out = stdout;
+    if (opts.output != NULL) {
+        out = fopen(opts.output, "w");
+        if (out == NULL) {
+            perror(opts.output);
+            return 1;
+        }
+    }
+
+    uint8_t *buf = malloc(opts.max_size > BENCH_FRAMES * BENCH_FRAME_LEN ?
+                          opts.max_size : BENCH_FRAMES * BENCH_FRAME_LEN);
+    if (buf == NULL) {
+        fprintf(stderr, "bench_crc: out of memory\n");
+        return 1;
+    }
+    for (size_t i = 0; i < opts.max_size || i < BENCH_FRAMES * BENCH_FRAME_LEN; i++) {
+        buf[i] = (uint8_t)((i * 2654435761u) >> 13);
+    }
+
+    if (opts.json) {
+        fprintf(out, "{\n  \"pclmul\": %s,\n  \"sse42\": %s,\n  \"min_time_ms\": %llu,\n"
+                     "  \"results\": [",
+                crc_clmul_available() ? "true" : "false",
+                crc32c_hw_available() ? "true" : "false",
+                (unsigned long long)(opts.min_ns / 1000000ULL));
+    } else {
+        fprintf(out, "CRC throughput (MB/s), PCLMULQDQ: %s, SSE4.2: %s\n",
+                crc_clmul_available() ? "yes" : "no",
+                crc32c_hw_available() ? "yes" : "no");
+    }
+
+    int first = 1;
+    for (int t = CRC_8; t <= CRC_64_JONES; t++) {
+        const char *name = crc_get_name((crc_type_t)t);
+
+        if (opts.type != NULL && strcmp(opts.type, name) != 0) {
+            continue;
+        }
+        if (_select_type((crc_type_t)t) != 0) {
+            continue;
+        }
+
+        if (!opts.json) {
+            fprintf(out, "\n%s\n%10s", name, "size");
+            for (size_t k = 0; k < KERNEL_COUNT; k++) {
+                if (opts.kernel == NULL || strcmp(opts.kernel, kernels[k].name) == 0) {
+                    fprintf(out, " %10s", kernels[k].name);
+                }
+            }
+            fprintf(out, "\n");
+        }
+
+        for (size_t s = 0; s < SIZE_COUNT && sizes[s] <= opts.max_size; s++) {
+            if (!opts.json) {
+                fprintf(out, "%10zu", sizes[s]);
+            }
+            for (size_t k = 0; k < KERNEL_COUNT; k++) {
+                if (opts.kernel != NULL && strcmp(opts.kernel, kernels[k].name) != 0) {
+                    continue;
+                }
+                if (!kernels[k].usable()) {
+                    if (!opts.json) {
+                        fprintf(out, " %10s", "-");
+                    }
+                    continue;
+                }
+
+                double mbps = _measure(kernels[k].fn, buf, sizes[s], opts.min_ns);
+                if (opts.json) {
+                    fprintf(out, "%s\n    {\"type\": \"%s\", \"kernel\": \"%s\", "
+                                 "\"size\": %zu, \"mb_per_s\": %.1f}",
+                            first ? "" : ",", name, kernels[k].name, sizes[s], mbps);
+                    first = 0;
+                } else {
+                    fprintf(out, " %10.1f", mbps);
+                }
+                fflush(out);
+            }
+            if (!opts.json) {
+                fprintf(out, "\n");
+            }
+        }
+
+        /* 批量接口：size 为帧长，吞吐折算为MB/s便于统一比较 */
+        if (opts.kernel == NULL || strcmp(opts.kernel, "many") == 0) {
+            double rate[2];
+            _measure_many((crc_type_t)t, buf, opts.min_ns, rate);
+            if (opts.json) {
+                fprintf(out, "%s\n    {\"type\": \"%s\", \"kernel\": \"many\", "
+                             "\"size\": %d, \"mb_per_s\": %.1f}",
+                        first ? "" : ",", name, BENCH_FRAME_LEN, rate[1] * BENCH_FRAME_LEN);
+                first = 0;
+            } else {
+                fprintf(out, "%d-byte frames: crc_compute %.2f Mframes/s, "
+                             "crc_compute_many %.2f Mframes/s\n",
+                        BENCH_FRAME_LEN, rate[0], rate[1]);
+            }
+        }
+    }
+
+    if (opts.json) {
+        fprintf(out, "\n  ]\n}\n");
+    }
+
+    free(buf);
+    if (out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}
@@ -10,10 +10,12 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stddef.h>
 #include <string.h>
 #include <stdint.h>
 #include "crc_api.h"
+#include "crc_nibble.h"
 
 /* 测试结果统计 */
 typedef struct {
@@ -384,7 +386,8 @@ static void test_streaming(test_stats_t *stats)
     }
     uint64_t crc_stream = crc_finalize_ctx(&ctx);
 
-    int passed = (crc_oneshot == crc_stream);
+    /* 默认逐位计算，不使用共享表 */
+    int passed = (crc_oneshot == crc_stream) && ctx.mode == CRC_MODE_BITWISE && ctx.slice == NULL;
     stats->total++;
     if (passed) {
         stats->passed++;
@@ -395,6 +398,577 @@ static void test_streaming(test_stats_t *stats)
     print_test_result("Streaming CRC-32", crc_oneshot, crc_stream, passed);
 }
 
+/**
+ * @brief 查表模式测试
+ *
+ * 对所有预定义算法，查表模式的校验值和分段结果须与逐位计算一致
+ */
+static void test_table_mode(test_stats_t *stats)
+{
+    printf("\n========== 查表模式测试 ==========\n");
+
+    uint8_t buf[1031];
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t)(i * 131 + 7);
+    }
+
+    for (int t = CRC_8; t <= CRC_64_JONES; t++) {
+        crc_type_t type = (crc_type_t)t;
+        uint64_t check = 0;
+        crc_ctx_t ctx;
+
+        crc_get_check_value(type, &check);
+
+        /* 校验值 */
+        crc_init(&ctx, type);
+        crc_set_mode(&ctx, CRC_MODE_TABLE);
+        crc_update_ctx(&ctx, (const uint8_t *)"123456789", 9);
+        uint64_t table_check = crc_finalize_ctx(&ctx);
+
+        /* 不规则分段，覆盖reset后复用表；以逐位计算为参考 */
+        crc_config_t config;
+        crc_get_config(type, &config);
+        uint64_t expected = crc_calc(buf, sizeof(buf), &config);
+        crc_reset(&ctx);
+        for (size_t off = 0, step = 1; off < sizeof(buf); off += step, step = step * 2 + 1) {
+            size_t len = (off + step < sizeof(buf)) ? step : sizeof(buf) - off;
+            crc_update_ctx(&ctx, buf + off, len);
+        }
+        uint64_t table_buf = crc_finalize_ctx(&ctx);
+
+        int passed = (table_check == check) && (table_buf == expected);
+        stats->total++;
+        if (passed) {
+            stats->passed++;
+        } else {
+            stats->failed++;
+        }
+
+        if (table_check != check) {
+            print_test_result(crc_get_name(type), check, table_check, passed);
+        } else {
+            print_test_result(crc_get_name(type), expected, table_buf, passed);
+        }
+    }
+}
+
+/**
+ * @brief slicing内核测试
+ *
+ * 对所有32/64位预定义算法，slicing-by-8/16及自动选择的结果
+ * 须在各种长度和起始偏移下与逐位计算一致
+ */
+static void test_slicing(test_stats_t *stats)
+{
+    printf("\n========== Slicing-by-8/16 测试 ==========\n");
+
+    static uint8_t buf[4099];
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t)((i * 2654435761u) >> 13);
+    }
+
+    const size_t lens[] = { 0, 1, 7, 8, 9, 15, 16, 17, 63, 64, 65, 255, 1000, 4096 };
+
+    for (int t = CRC_8; t <= CRC_64_JONES; t++) {
+        crc_type_t type = (crc_type_t)t;
+        crc_config_t config;
+
+        crc_get_config(type, &config);
+        if (!crc_slice_supported(&config)) {
+            continue;
+        }
+
+        const crc_slice_table_t *slice = crc_slice_get(&config);
+        int passed = (slice != NULL);
+        uint64_t expected = 0, actual = 0;
+
+        for (size_t k = 0; passed && k < sizeof(lens) / sizeof(lens[0]); k++) {
+            for (size_t off = 0; passed && off < 3; off++) {
+                const uint8_t *p = buf + off;
+                size_t len = lens[k];
+                uint64_t init = config.init_crc ^ config.xor_out;
+
+                expected = crc_finalize(crc_update(p, len, init, &config), &config);
+
+                actual = crc_finalize(crc_update_slice8(p, len, init, slice), &config);
+                passed = (actual == expected);
+                if (passed) {
+                    actual = crc_finalize(crc_update_slice16(p, len, init, slice), &config);
+                    passed = (actual == expected);
+                }
+                if (passed) {
+                    actual = crc_compute(type, p, len);
+                    passed = (actual == expected);
+                }
+            }
+        }
+
+        /* 上下文各模式分段结果 */
+        const crc_mode_t modes[] = { CRC_MODE_SLICE8, CRC_MODE_SLICE16, CRC_MODE_AUTO };
+        for (size_t m = 0; passed && m < sizeof(modes) / sizeof(modes[0]); m++) {
+            crc_ctx_t ctx;
+            crc_init(&ctx, type);
+            crc_set_mode(&ctx, modes[m]);
+            crc_update_ctx(&ctx, buf, 5);
+            crc_update_ctx(&ctx, buf + 5, 100);
+            crc_update_ctx(&ctx, buf + 105, sizeof(buf) - 105);
+            expected = crc_calc(buf, sizeof(buf), &config);
+            actual = crc_finalize_ctx(&ctx);
+            passed = (actual == expected);
+        }
+
+        stats->total++;
+        if (passed) {
+            stats->passed++;
+        } else {
+            stats->failed++;
+        }
+        print_test_result(crc_get_name(type), expected, actual, passed);
+    }
+
+    /* 不支持的宽度不能选择slicing模式 */
+    crc_ctx_t ctx;
+    crc_init(&ctx, CRC_MODBUS);
+    int passed = (crc_set_mode(&ctx, CRC_MODE_SLICE8) == -1);
+    stats->total++;
+    if (passed) {
+        stats->passed++;
+    } else {
+        stats->failed++;
+    }
+    printf("  [%s] CRC_MODE_SLICE8 rejected for 16-bit CRC\n", passed ? "PASS" : "FAIL");
+}
+
+/**
+ * @brief 折叠内核测试
+ *
+ * 对所有预定义算法（8~64位、前向/反向），折叠内核在各种长度下
+ * 须与逐位计算一致；CPU不支持时验证的是字节表退化路径
+ */
+static void test_clmul(test_stats_t *stats)
+{
+    printf("\n========== PCLMULQDQ 折叠测试 (CPU支持: %s) ==========\n",
+           crc_clmul_available() ? "是" : "否");
+
+    static uint8_t buf[4099];
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t)((i * 2246822519u) >> 11);
+    }
+
+    const size_t lens[] = { 0, 15, 16, 31, 32, 33, 127, 128, 129, 191, 192, 256, 1000, 4097 };
+
+    for (int t = CRC_8; t <= CRC_64_JONES; t++) {
+        crc_type_t type = (crc_type_t)t;
+        crc_config_t config;
+        uint64_t expected = 0, actual = 0;
+
+        crc_get_config(type, &config);
+        const crc_clmul_t *clmul = crc_clmul_get(&config);
+        int passed = (clmul != NULL);
+
+        for (size_t k = 0; passed && k < sizeof(lens) / sizeof(lens[0]); k++) {
+            for (size_t off = 0; passed && off < 2; off++) {
+                uint64_t init = config.init_crc ^ config.xor_out;
+                expected = crc_finalize(crc_update(buf + off, lens[k], init, &config), &config);
+                actual = crc_finalize(crc_update_clmul(buf + off, lens[k], init, clmul), &config);
+                passed = (actual == expected);
+                if (passed) {
+                    actual = crc_compute(type, buf + off, lens[k]);
+                    passed = (actual == expected);
+                }
+            }
+        }
+
+        /* 上下文折叠模式分段结果 */
+        if (passed) {
+            crc_ctx_t ctx;
+            crc_init(&ctx, type);
+            passed = (crc_set_mode(&ctx, CRC_MODE_CLMUL) == 0);
+            crc_update_ctx(&ctx, buf, 300);
+            crc_update_ctx(&ctx, buf + 300, 7);
+            crc_update_ctx(&ctx, buf + 307, sizeof(buf) - 307);
+            expected = crc_calc(buf, sizeof(buf), &config);
+            actual = crc_finalize_ctx(&ctx);
+            passed = passed && (actual == expected);
+        }
+
+        stats->total++;
+        if (passed) {
+            stats->passed++;
+        } else {
+            stats->failed++;
+        }
+        print_test_result(crc_get_name(type), expected, actual, passed);
+    }
+}
+
+/**
+ * @brief SSE4.2 crc32指令路径测试
+ *
+ * 覆盖对齐前缀、三路并行的长/短块以及8字节/单字节尾部，
+ * 各长度与起始偏移下须与逐位计算一致；CPU不支持时验证的是slicing-by-8退化路径
+ */
+static void test_sse42(test_stats_t *stats)
+{
+    printf("\n========== SSE4.2 CRC-32C 测试 (CPU支持: %s) ==========\n",
+           crc32c_hw_available() ? "是" : "否");
+
+    static uint8_t buf[3 * 8192 * 2 + 3 * 256 + 64];
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t)((i * 2654435761u) >> 13);
+    }
+
+    const size_t lens[] = { 0, 1, 7, 8, 9, 63, 767, 768, 769, 1543,
+                            3 * 8192 - 1, 3 * 8192, 3 * 8192 + 3 * 256 + 13,
+                            sizeof(buf) - 8 };
+    crc_config_t config;
+    crc_get_config(CRC_32C, &config);
+
+    for (size_t k = 0; k < sizeof(lens) / sizeof(lens[0]); k++) {
+        uint64_t expected = 0, actual = 0;
+        int passed = 1;
+        char name[32];
+
+        for (size_t off = 0; passed && off < 8; off++) {
+            expected = crc_update(buf + off, lens[k], 0xFFFFFFFF, &config);
+            actual = crc32c_update_hw(buf + off, lens[k], 0xFFFFFFFF);
+            passed = (actual == expected);
+            if (passed) {
+                expected = crc_calc(buf + off, lens[k], &config);
+                actual = crc_compute(CRC_32C, buf + off, lens[k]);
+                passed = (actual == expected);
+            }
+        }
+
+        snprintf(name, sizeof(name), "CRC-32C len=%zu", lens[k]);
+        stats->total++;
+        if (passed) {
+            stats->passed++;
+        } else {
+            stats->failed++;
+        }
+        print_test_result(name, expected, actual, passed);
+    }
+
+    /* 上下文SSE4.2模式分段结果，以及非CRC-32C配置拒绝该模式 */
+    crc_ctx_t ctx;
+    crc_init(&ctx, CRC_32C);
+    int passed = (crc_set_mode(&ctx, CRC_MODE_SSE42) == 0);
+    crc_update_ctx(&ctx, buf, 8);
+    crc_update_ctx(&ctx, buf + 8, 5000);
+    crc_update_ctx(&ctx, buf + 5008, sizeof(buf) - 5008);
+    uint64_t expected = crc_calc(buf, sizeof(buf), &config);
+    uint64_t actual = crc_finalize_ctx(&ctx);
+    passed = passed && (actual == expected);
+
+    crc_init(&ctx, CRC_32);
+    passed = passed && (crc_set_mode(&ctx, CRC_MODE_SSE42) != 0);
+
+    stats->total++;
+    if (passed) {
+        stats->passed++;
+    } else {
+        stats->failed++;
+    }
+    print_test_result("CRC-32C ctx", expected, actual, passed);
+}
+
+/**
+ * @brief CRC合并、填充扩展与多线程计算测试
+ *
+ * 对所有预定义算法，任意切分点的合并结果、追加零字节/0xFF字节的结果
+ * 均须与对完整数据直接计算一致
+ */
+static void test_combine(test_stats_t *stats)
+{
+    printf("\n========== CRC 合并/扩展测试 ==========\n");
+
+    static uint8_t buf[1500];
+    static uint8_t fill[1500];
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t)((i * 2246822519u) >> 7);
+    }
+
+    const size_t splits[] = { 0, 1, 8, 333, 1024, 1499, 1500 };
+    const size_t fills[] = { 0, 1, 7, 64, 1000 };
+
+    for (int t = CRC_8; t <= CRC_64_JONES; t++) {
+        crc_type_t type = (crc_type_t)t;
+        crc_config_t config;
+        uint64_t expected = 0, actual = 0;
+        int passed = 1;
+
+        crc_get_config(type, &config);
+        expected = crc_calc(buf, sizeof(buf), &config);
+
+        for (size_t k = 0; passed && k < sizeof(splits) / sizeof(splits[0]); k++) {
+            size_t la = splits[k];
+            uint64_t a = crc_calc(buf, la, &config);
+            uint64_t b = crc_calc(buf + la, sizeof(buf) - la, &config);
+            actual = crc_combine(a, b, sizeof(buf) - la, &config);
+            passed = (actual == expected);
+        }
+
+        for (size_t k = 0; passed && k < sizeof(fills) / sizeof(fills[0]); k++) {
+            for (int f = 0; passed && f < 2; f++) {
+                uint8_t value = f ? 0xFF : 0x00;
+                memcpy(fill, buf, 100);
+                memset(fill + 100, value, fills[k]);
+                expected = crc_calc(fill, 100 + fills[k], &config);
+                actual = crc_append_fill(crc_calc(fill, 100, &config), fills[k], value, &config);
+                passed = (actual == expected);
+            }
+        }
+
+        stats->total++;
+        if (passed) {
+            stats->passed++;
+        } else {
+            stats->failed++;
+        }
+        print_test_result(crc_get_name(type), expected, actual, passed);
+    }
+
+    /* 多线程计算：含不能整除的尾块 */
+    const size_t big_len = 4 * CRC_PARALLEL_MIN_CHUNK + 12345;
+    uint8_t *big = malloc(big_len);
+    if (big != NULL) {
+        for (size_t i = 0; i < big_len; i++) {
+            big[i] = (uint8_t)((i * 2654435761u) >> 13);
+        }
+
+        const crc_type_t types[] = { CRC_MODBUS, CRC_32, CRC_32C, CRC_64_WE };
+        for (size_t k = 0; k < sizeof(types) / sizeof(types[0]); k++) {
+            uint64_t expected = crc_compute(types[k], big, big_len);
+            uint64_t actual = crc_compute_parallel(types[k], big, big_len, 4);
+            int passed = (actual == expected) &&
+                         (crc_compute_parallel(types[k], big, big_len, 0) == expected) &&
+                         (crc_compute_parallel(types[k], big, 1000, 4) ==
+                          crc_compute(types[k], big, 1000));
+
+            stats->total++;
+            if (passed) {
+                stats->passed++;
+            } else {
+                stats->failed++;
+            }
+            print_test_result("parallel", expected, actual, passed);
+        }
+        free(big);
+    }
+}
+
+/**
+ * @brief 批量计算测试
+ *
+ * 等长短帧、不等长、长短混合、空指针以及不足一组的尾部缓冲区，
+ * 结果须与逐个调用 crc_compute() 一致
+ */
+static void test_compute_many(test_stats_t *stats)
+{
+    printf("\n========== 批量计算测试 ==========\n");
+
+    enum { COUNT = 39 };
+    static uint8_t buf[8192];
+    const uint8_t *bufs[COUNT];
+    size_t lens[COUNT];
+    uint64_t out[COUNT];
+
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t)((i * 2246822519u) >> 9);
+    }
+
+    for (int t = CRC_8; t <= CRC_64_JONES; t++) {
+        crc_type_t type = (crc_type_t)t;
+        uint64_t expected = 0, actual = 0;
+        int passed = 1;
+
+        for (int layout = 0; passed && layout < 3; layout++) {
+            for (size_t i = 0; i < COUNT; i++) {
+                switch (layout) {
+                case 0:     /* 8字节CAN帧 */
+                    lens[i] = 8;
+                    break;
+                case 1:     /* 不等长短数据 */
+                    lens[i] = (i * 7) % 61;
+                    break;
+                default:    /* 长短混合 */
+                    lens[i] = (i % 5 == 0) ? 300 + i * 97 : (i * 13) % 200;
+                    break;
+                }
+                bufs[i] = buf + (i * 131) % (sizeof(buf) - lens[i]);
+            }
+            if (layout == 1) {
+                bufs[5] = NULL;
+            }
+
+            passed = (crc_compute_many(type, bufs, lens, out, COUNT) == 0);
+            for (size_t i = 0; passed && i < COUNT; i++) {
+                expected = crc_compute(type, bufs[i], bufs[i] ? lens[i] : 0);
+                actual = out[i];
+                passed = (actual == expected);
+            }
+        }
+
+        stats->total++;
+        if (passed) {
+            stats->passed++;
+        } else {
+            stats->failed++;
+        }
+        print_test_result(crc_get_name(type), expected, actual, passed);
+    }
+}
+
+/**
+ * @brief Zephyr crc16_ccitt() 参考实现（subsys/crc/crc16_sw.c）
+ */
+static uint16_t zephyr_crc16_ccitt(uint16_t seed, const uint8_t *src, size_t len)
+{
+    for (; len > 0; len--) {
+        uint8_t e = (uint8_t)(seed ^ *src++);
+        uint8_t f = (uint8_t)(e ^ (e << 4));
+        seed = (uint16_t)((seed >> 8) ^ ((uint16_t)f << 8) ^ ((uint16_t)f << 3) ^
+                          ((uint16_t)f >> 4));
+    }
+    return seed;
+}
+
+/**
+ * @brief 半字节查表实现测试（crc_nibble.h）
+ */
+static void test_nibble(test_stats_t *stats)
+{
+    printf("\n========== 半字节查表测试 ==========\n");
+
+    static uint8_t buf[1031];
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t)((i * 2654435761u) >> 11);
+    }
+
+    static const size_t lens[] = { 0, 1, 2, 7, 64, 255, 1031 };
+    uint64_t expected = 0, actual = 0;
+    int passed;
+
+    /* MODBUS：一次计算与分段计算 */
+    passed = 1;
+    for (size_t i = 0; passed && i < sizeof(lens) / sizeof(lens[0]); i++) {
+        expected = crc_compute(CRC_MODBUS, buf, lens[i]);
+        actual = crc16_modbus_nibble(buf, lens[i]);
+        passed = (actual == expected);
+    }
+    if (passed) {
+        uint16_t crc = crc16_modbus_nibble_update(0xFFFF, buf, 500);
+        actual = crc16_modbus_nibble_update(crc, buf + 500, sizeof(buf) - 500);
+        expected = crc_compute(CRC_MODBUS, buf, sizeof(buf));
+        passed = (actual == expected);
+    }
+    stats->total++;
+    if (passed) {
+        stats->passed++;
+    } else {
+        stats->failed++;
+    }
+    print_test_result("MODBUS nibble", expected, actual, passed);
+
+    /* Zephyr crc16_ccitt：seed 0 即 KERMIT，非零 seed 与参考实现一致 */
+    passed = 1;
+    for (size_t i = 0; passed && i < sizeof(lens) / sizeof(lens[0]); i++) {
+        expected = crc_compute(CRC_ZEPHYR_CCITT, buf, lens[i]);
+        actual = crc16_ccitt_zephyr_nibble(0, buf, lens[i]);
+        passed = (actual == expected) &&
+                 (zephyr_crc16_ccitt(0x1D0F, buf, lens[i]) ==
+                  crc16_ccitt_zephyr_nibble(0x1D0F, buf, lens[i]));
+    }
+    stats->total++;
+    if (passed) {
+        stats->passed++;
+    } else {
+        stats->failed++;
+    }
+    print_test_result("Zephyr CCITT nibble", expected, actual, passed);
+
+    /* CRC-32：校验值 "123456789" = 0xCBF43926，一次计算与分段计算 */
+    expected = 0xCBF43926;
+    actual = crc32_nibble((const uint8_t *)"123456789", 9);
+    passed = (actual == expected);
+    for (size_t i = 0; passed && i < sizeof(lens) / sizeof(lens[0]); i++) {
+        expected = crc_compute(CRC_32, buf, lens[i]);
+        actual = crc32_nibble(buf, lens[i]);
+        passed = (actual == expected);
+    }
+    if (passed) {
+        uint32_t crc = crc32_nibble_continue(0, buf, 500);
+        actual = crc32_nibble_continue(crc, buf + 500, sizeof(buf) - 500);
+        expected = crc_compute(CRC_32, buf, sizeof(buf));
+        passed = (actual == expected);
+    }
+    stats->total++;
+    if (passed) {
+        stats->passed++;
+    } else {
+        stats->failed++;
+    }
+    print_test_result("CRC-32 nibble", expected, actual, passed);
+}
+
+/**
+ * @brief 按名称查找CRC类型测试
+ */
+static void test_type_by_name(test_stats_t *stats)
+{
+    printf("\n========== 名称查找测试 ==========\n");
+
+    static const struct {
+        const char *name;
+        int expected;           /* 期望类型，-1 表示应查找失败 */
+    } cases[] = {
+        { "CRC-32C",     CRC_32C },
+        { "crc32c",      CRC_32C },
+        { "32c",         CRC_32C },
+        { "CRC_MODBUS",  CRC_MODBUS },
+        { "modbus",      CRC_MODBUS },
+        { "X-25",        CRC_X25 },
+        { "crc-16-usb",  CRC_16_USB },
+        { "zephyr_ccitt", CRC_ZEPHYR_CCITT },
+        { "CRC-99",      -1 },
+        { "",            -1 },
+    };
+
+    /* 所有类型的规范名称均能反查回自身 */
+    int passed = 1;
+    for (int t = CRC_8; t <= CRC_64_JONES; t++) {
+        crc_type_t found;
+        if (crc_get_type_by_name(crc_get_name((crc_type_t)t), &found) != 0 ||
+            found != (crc_type_t)t) {
+            printf("  [FAIL] %s\n", crc_get_name((crc_type_t)t));
+            passed = 0;
+        }
+    }
+    stats->total++;
+    if (passed) {
+        stats->passed++;
+        printf("  [PASS] %-20s\n", "canonical names");
+    } else {
+        stats->failed++;
+    }
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        crc_type_t found = CRC_CUSTOM;
+        int ret = crc_get_type_by_name(cases[i].name, &found);
+        passed = (cases[i].expected < 0) ? (ret != 0)
+                                         : (ret == 0 && found == (crc_type_t)cases[i].expected);
+        stats->total++;
+        if (passed) {
+            stats->passed++;
+            printf("  [PASS] %-20s\n", cases[i].name);
+        } else {
+            stats->failed++;
+            printf("  [FAIL] %-20s\n", cases[i].name);
+        }
+    }
+}
+
 /**
  * @brief 实用示例演示
  */
@@ -455,6 +1029,14 @@ int main(void)
     test_bit_reverse(&stats);
     test_edge_cases(&stats);
     test_streaming(&stats);
+    test_table_mode(&stats);
+    test_slicing(&stats);
+    test_clmul(&stats);
+    test_sse42(&stats);
+    test_combine(&stats);
+    test_compute_many(&stats);
+    test_type_by_name(&stats);
+    test_nibble(&stats);
 
     /* 显示示例 */
     demo_usage_examples();
@@ -0,0 +1,142 @@
+/**
+ * @file test_crc_hpp.cpp
+ * @brief crc.hpp 模板测试程序
+ *
+ * 编译期：常用算法对 "123456789" 的校验值由 static_assert 验证；
+ * 运行期：全部预定义配置与C库 crc_api 的配置表、校验值及各长度计算结果交叉校验。
+ *
+ * @date 2026-10-18
+ * @license MIT
+ */
+
+#include <cstdio>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include "crc.hpp"
+#include "crc_api.h"
+
+/* ============================================================================
+ * 编译期校验
+ * ============================================================================ */
+
+static_assert(crc::crc_8::compute("123456789") == 0xF4);
+static_assert(crc::modbus::compute("123456789") == 0x4B37);
+static_assert(crc::xmodem::compute("123456789") == 0x31C3);
+static_assert(crc::kermit::compute("123456789") == 0x2189);
+static_assert(crc::zephyr_ccitt::compute("123456789") == 0x2189);
+static_assert(crc::crc_32::compute("123456789") == 0xCBF43926);
+static_assert(crc::crc_32c::compute("123456789") == 0xE3069283);
+static_assert(crc::crc_64_we::compute("123456789") == 0x62EC59E3F1A4F00A);
+static_assert(crc::engine<crc::cfg::crc_24>::compute("123456789") == 0x21CF02);
+
+static_assert(std::is_same_v<crc::crc_8::value_type, std::uint8_t>);
+static_assert(std::is_same_v<crc::modbus::value_type, std::uint16_t>);
+static_assert(std::is_same_v<crc::engine<crc::cfg::crc_24>::value_type, std::uint32_t>);
+static_assert(std::is_same_v<crc::crc_64::value_type, std::uint64_t>);
+
+/* ============================================================================
+ * 运行期交叉校验
+ * ============================================================================ */
+
+struct test_stats {
+    int total = 0;
+    int passed = 0;
+};
+
+static std::uint8_t g_buf[1031];
+
+template <crc::config C>
+static void check(test_stats &stats, crc_type_t type)
+{
+    using E = crc::engine<C>;
+    crc_config_t c_cfg;
+    std::uint64_t check_value = 0;
+    bool passed = (crc_get_config(type, &c_cfg) == 0) &&
+                  (crc_get_check_value(type, &check_value) == 0);
+
+    /* 配置与C库配置表一致 */
+    passed = passed && c_cfg.poly == C.poly && c_cfg.init_crc == C.init &&
+             c_cfg.xor_out == C.xor_out && c_cfg.width_bits == C.width &&
+             (c_cfg.reverse != 0) == C.reverse && (c_cfg.refout != 0) == C.refout;
+
+    passed = passed && E::compute("123456789") == check_value;
+
+    for (std::size_t len : {0u, 1u, 7u, 64u, 1000u, 1031u}) {
+        std::span<const std::uint8_t> data(g_buf, len);
+        passed = passed && E::compute(data) == crc_calc(g_buf, len, &c_cfg);
+    }
+
+    /* 分段更新 */
+    auto reg = E::update(E::init(), std::span<const std::uint8_t>(g_buf, 500));
+    reg = E::update(reg, g_buf + 500, sizeof(g_buf) - 500);
+    passed = passed && E::finalize(reg) == crc_calc(g_buf, sizeof(g_buf), &c_cfg);
+
+    stats.total++;
+    if (passed) {
+        stats.passed++;
+        std::printf("  [PASS] %s\n", crc_get_name(type));
+    } else {
+        std::printf("  [FAIL] %s\n", crc_get_name(type));
+    }
+}
+
+int main()
+{
+    test_stats stats;
+
+    for (std::size_t i = 0; i < sizeof(g_buf); i++) {
+        g_buf[i] = static_cast<std::uint8_t>((i * 2654435761u) >> 13);
+    }
+
+    std::printf("\n========== crc.hpp 交叉校验 ==========\n");
+
+    check<crc::cfg::crc_8>(stats, CRC_8);
+    check<crc::cfg::crc_8_darc>(stats, CRC_8_DARC);
+    check<crc::cfg::crc_8_i_code>(stats, CRC_8_I_CODE);
+    check<crc::cfg::crc_8_itu>(stats, CRC_8_ITU);
+    check<crc::cfg::crc_8_maxim>(stats, CRC_8_MAXIM);
+    check<crc::cfg::crc_8_rohc>(stats, CRC_8_ROHC);
+    check<crc::cfg::crc_8_wcdma>(stats, CRC_8_WCDMA);
+
+    check<crc::cfg::crc_16>(stats, CRC_16);
+    check<crc::cfg::crc_16_bypass>(stats, CRC_16_BYPASS);
+    check<crc::cfg::crc_16_dds_110>(stats, CRC_16_DDS_110);
+    check<crc::cfg::crc_16_dect>(stats, CRC_16_DECT);
+    check<crc::cfg::crc_16_dnp>(stats, CRC_16_DNP);
+    check<crc::cfg::crc_16_en_13757>(stats, CRC_16_EN_13757);
+    check<crc::cfg::crc_16_genibus>(stats, CRC_16_GENIBUS);
+    check<crc::cfg::crc_16_maxim>(stats, CRC_16_MAXIM);
+    check<crc::cfg::crc_16_mcrf4xx>(stats, CRC_16_MCRF4XX);
+    check<crc::cfg::crc_16_riello>(stats, CRC_16_RIELLO);
+    check<crc::cfg::crc_16_t10_dif>(stats, CRC_16_T10_DIF);
+    check<crc::cfg::crc_16_teledisk>(stats, CRC_16_TELEDISK);
+    check<crc::cfg::crc_16_usb>(stats, CRC_16_USB);
+    check<crc::cfg::x25>(stats, CRC_X25);
+    check<crc::cfg::xmodem>(stats, CRC_XMODEM);
+    check<crc::cfg::modbus>(stats, CRC_MODBUS);
+    check<crc::cfg::ccitt_false>(stats, CRC_CCITT_FALSE);
+    check<crc::cfg::aug_ccitt>(stats, CRC_AUG_CCITT);
+    check<crc::cfg::kermit>(stats, CRC_KERMIT);
+
+    check<crc::cfg::crc_24>(stats, CRC_24);
+    check<crc::cfg::crc_24_flexray_a>(stats, CRC_24_FLEXRAY_A);
+    check<crc::cfg::crc_24_flexray_b>(stats, CRC_24_FLEXRAY_B);
+
+    check<crc::cfg::crc_32>(stats, CRC_32);
+    check<crc::cfg::crc_32_bzip2>(stats, CRC_32_BZIP2);
+    check<crc::cfg::crc_32c>(stats, CRC_32C);
+    check<crc::cfg::crc_32d>(stats, CRC_32D);
+    check<crc::cfg::crc_32_mpeg>(stats, CRC_32_MPEG);
+    check<crc::cfg::posix>(stats, CRC_POSIX);
+    check<crc::cfg::crc_32q>(stats, CRC_32Q);
+    check<crc::cfg::jamcrc>(stats, CRC_JAMCRC);
+    check<crc::cfg::xfer>(stats, CRC_XFER);
+
+    check<crc::cfg::crc_64>(stats, CRC_64);
+    check<crc::cfg::crc_64_we>(stats, CRC_64_WE);
+    check<crc::cfg::crc_64_jones>(stats, CRC_64_JONES);
+
+    std::printf("\n  通过: %d / %d\n\n", stats.passed, stats.total);
+    return (stats.passed == stats.total) ? 0 : 1;
+}
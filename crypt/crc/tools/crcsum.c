@@ -0,0 +1,501 @@
+/**
+ * @file crcsum.c
+ * @brief CRC校验和命令行工具
+ *
+ * 用法与 sha256sum 相同，算法由 -a 指定（名称见 crcsum -l）：
+ *
+ * @code
+ * crcsum -a CRC-32C build/app.bin build/boot.bin > SUMS
+ * crcsum -a CRC-32C -c SUMS
+ * @endcode
+ *
+ * - 普通文件通过mmap映射后计算，单个大文件使用 crc_compute_parallel() 多线程计算
+ * - 多个文件由 -j 个工作线程并发计算，结果按命令行顺序输出
+ * - 输出格式为 "<十六进制CRC>  <文件名>"，-c 模式读取同格式文件逐项校验
+ *
+ * @date 2026-10-18
+ * @license MIT
+ */
+
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#define CRCSUM_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define CRCSUM_HAVE_MMAP 0
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "crc_api.h"
+
+#if !defined(__STDC_NO_THREADS__) && defined(__has_include)
+#if __has_include(<threads.h>)
+#define CRCSUM_HAVE_THREADS 1
+#include <threads.h>
+#include <stdatomic.h>
+#endif
+#endif
+
+#ifndef CRCSUM_HAVE_THREADS
+#define CRCSUM_HAVE_THREADS 0
+#endif
+
+/* ============================================================================
+ * 私有定义
+ * ============================================================================ */
+
+/** @brief 默认算法 */
+#define CRCSUM_DEFAULT_TYPE CRC_32
+
+/** @brief 最大工作线程数 */
+#define CRCSUM_MAX_JOBS 64
+
+/** @brief 流式读取缓冲区大小 */
+#define CRCSUM_READ_CHUNK (256u * 1024u)
+
+/** @brief 校验文件单行最大长度 */
+#define CRCSUM_LINE_MAX 4096
+
+/** @brief 单个文件的计算任务 */
+typedef struct {
+    char *path;             /**< 文件名（"-" 表示标准输入） */
+    uint64_t expected;      /**< -c 模式下的期望值 */
+    uint64_t crc;           /**< 计算结果 */
+    int err;                /**< 0 成功，否则为errno */
+#if CRCSUM_HAVE_THREADS
+    atomic_int done;        /**< 计算完成标志 */
+#endif
+} crcsum_job_t;
+
+/** @brief 运行参数 */
+typedef struct {
+    crc_type_t type;
+    unsigned jobs;
+    int check;
+    int quiet;
+} crcsum_opts_t;
+
+/** @brief 任务队列 */
+typedef struct {
+    crcsum_job_t *items;
+    size_t count;
+    const crcsum_opts_t *opts;
+    unsigned file_threads;  /**< 单个文件内部的并行线程数 */
+#if CRCSUM_HAVE_THREADS
+    atomic_size_t next;
+    mtx_t lock;
+    cnd_t cond;
+#endif
+} crcsum_queue_t;
+
+/* ============================================================================
+ * 文件计算
+ * ============================================================================ */
+
+/**
+ * @brief 流式读取计算（标准输入、管道以及不支持mmap的平台）
+ */
+static int _hash_stream(FILE *fp, crc_type_t type, uint64_t *crc)
+{
+    uint8_t *buf = malloc(CRCSUM_READ_CHUNK);
+    crc_ctx_t ctx;
+    size_t n;
+
+    if (buf == NULL) {
+        return ENOMEM;
+    }
+
+    crc_init(&ctx, type);
+    crc_set_mode(&ctx, CRC_MODE_AUTO);
+    while ((n = fread(buf, 1, CRCSUM_READ_CHUNK, fp)) > 0) {
+        crc_update_ctx(&ctx, buf, n);
+    }
+    free(buf);
+
+    if (ferror(fp)) {
+        return EIO;
+    }
+    *crc = crc_finalize_ctx(&ctx);
+    return 0;
+}
+
+/**
+ * @brief 计算单个文件的CRC
+ *
+ * @return 0 成功，否则为errno
+ */
+static int _hash_file(const char *path, crc_type_t type, unsigned threads, uint64_t *crc)
+{
+    if (strcmp(path, "-") == 0) {
+        return _hash_stream(stdin, type, crc);
+    }
+
+#if CRCSUM_HAVE_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return errno;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int err = errno;
+        close(fd);
+        return err;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        close(fd);
+        return EISDIR;
+    }
+
+    if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        size_t len = (size_t)st.st_size;
+        void *map = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (map != MAP_FAILED) {
+            posix_madvise(map, len, POSIX_MADV_SEQUENTIAL);
+            *crc = crc_compute_parallel(type, map, len, threads);
+            munmap(map, len);
+            close(fd);
+            return 0;
+        }
+    }
+    close(fd);
+#else
+    (void)threads;
+#endif
+
+    /* 空文件、特殊文件或映射失败时退化为流式读取 */
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) {
+        return errno;
+    }
+    int err = _hash_stream(fp, type, crc);
+    fclose(fp);
+    return err;
+}
+
+/* ============================================================================
+ * 并发调度
+ * ============================================================================ */
+
+#if CRCSUM_HAVE_THREADS
+static int _worker(void *arg)
+{
+    crcsum_queue_t *q = arg;
+
+    for (;;) {
+        size_t i = atomic_fetch_add(&q->next, 1);
+        if (i >= q->count) {
+            return 0;
+        }
+
+        crcsum_job_t *job = &q->items[i];
+        job->err = _hash_file(job->path, q->opts->type, q->file_threads, &job->crc);
+
+        mtx_lock(&q->lock);
+        atomic_store(&job->done, 1);
+        cnd_broadcast(&q->cond);
+        mtx_unlock(&q->lock);
+    }
+}
+#endif
+
+/**
+ * @brief 输出单个任务结果
+ *
+ * @return 0 成功/校验通过，1 失败
+ */
+static int _report(const crcsum_job_t *job, const crcsum_opts_t *opts)
+{
+    crc_config_t config;
+    crc_get_config(opts->type, &config);
+    const int digits = (config.width_bits + 3) / 4;
+
+    if (job->err != 0) {
+        if (opts->check) {
+            printf("%s: FAILED open or read\n", job->path);
+        }
+        fprintf(stderr, "crcsum: %s: %s\n", job->path, strerror(job->err));
+        return 1;
+    }
+
+    if (!opts->check) {
+        printf("%0*llx  %s\n", digits, (unsigned long long)job->crc, job->path);
+        return 0;
+    }
+
+    if (job->crc != job->expected) {
+        printf("%s: FAILED\n", job->path);
+        return 1;
+    }
+    if (!opts->quiet) {
+        printf("%s: OK\n", job->path);
+    }
+    return 0;
+}
+
+/**
+ * @brief 计算全部任务并按顺序输出
+ *
+ * @return 失败的任务数
+ */
+static size_t _run(crcsum_job_t *items, size_t count, const crcsum_opts_t *opts)
+{
+    size_t failed = 0;
+    unsigned workers = opts->jobs;
+
+    if (workers > count) {
+        workers = (unsigned)count;
+    }
+
+#if CRCSUM_HAVE_THREADS
+    crcsum_queue_t q = {
+        .items = items, .count = count, .opts = opts,
+        /* 只有一个文件时由 crc_compute_parallel() 在文件内部并行 */
+        .file_threads = (count == 1) ? opts->jobs : 1,
+    };
+    thrd_t tids[CRCSUM_MAX_JOBS];
+    unsigned started = 0;
+
+    atomic_init(&q.next, 0);
+    for (size_t i = 0; i < count; i++) {
+        atomic_init(&items[i].done, 0);
+    }
+
+    if (workers > 1 && mtx_init(&q.lock, mtx_plain) == thrd_success) {
+        if (cnd_init(&q.cond) == thrd_success) {
+            for (; started < workers; started++) {
+                if (thrd_create(&tids[started], _worker, &q) != thrd_success) {
+                    break;
+                }
+            }
+            if (started == 0) {
+                cnd_destroy(&q.cond);
+            }
+        }
+        if (started == 0) {
+            mtx_destroy(&q.lock);
+        }
+    }
+
+    if (started > 0) {
+        for (size_t i = 0; i < count; i++) {
+            mtx_lock(&q.lock);
+            while (!atomic_load(&items[i].done)) {
+                cnd_wait(&q.cond, &q.lock);
+            }
+            mtx_unlock(&q.lock);
+            failed += (size_t)_report(&items[i], opts);
+            fflush(stdout);
+        }
+        for (unsigned t = 0; t < started; t++) {
+            thrd_join(tids[t], NULL);
+        }
+        cnd_destroy(&q.cond);
+        mtx_destroy(&q.lock);
+        return failed;
+    }
+    const unsigned file_threads = q.file_threads;
+#else
+    const unsigned file_threads = 1;
+#endif
+
+    for (size_t i = 0; i < count; i++) {
+        items[i].err = _hash_file(items[i].path, opts->type, file_threads, &items[i].crc);
+        failed += (size_t)_report(&items[i], opts);
+    }
+    return failed;
+}
+
+/* ============================================================================
+ * 校验文件解析
+ * ============================================================================ */
+
+/**
+ * @brief 读取 "<hex>  <name>" 格式的校验文件，追加到任务列表
+ *
+ * @return 0 成功，-1 打开失败或内存不足
+ */
+static int _load_check_file(const char *path, crcsum_job_t **items, size_t *count,
+                            size_t *cap, size_t *bad_lines)
+{
+    FILE *fp = (strcmp(path, "-") == 0) ? stdin : fopen(path, "r");
+    char line[CRCSUM_LINE_MAX];
+
+    if (fp == NULL) {
+        fprintf(stderr, "crcsum: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        size_t n = strlen(line);
+        while (n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r')) {
+            line[--n] = '\0';
+        }
+        if (n == 0 || line[0] == '#') {
+            continue;
+        }
+
+        /* sha256sum 格式：值与文件名之间为两个空格，二进制模式为 " *" */
+        char *end;
+        uint64_t value = strtoull(line, &end, 16);
+        if (end == line || end[0] != ' ' || (end[1] != ' ' && end[1] != '*') ||
+            end[2] == '\0') {
+            (*bad_lines)++;
+            continue;
+        }
+
+        if (*count == *cap) {
+            size_t new_cap = (*cap == 0) ? 64 : *cap * 2;
+            crcsum_job_t *grown = realloc(*items, new_cap * sizeof(**items));
+            if (grown == NULL) {
+                break;
+            }
+            *items = grown;
+            *cap = new_cap;
+        }
+
+        crcsum_job_t *job = &(*items)[(*count)++];
+        memset(job, 0, sizeof(*job));
+        job->path = strdup(end + 2);
+        job->expected = value;
+        if (job->path == NULL) {
+            (*count)--;
+            break;
+        }
+    }
+
+    int ok = !ferror(fp);
+    if (fp != stdin) {
+        fclose(fp);
+    }
+    return ok ? 0 : -1;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+static void _usage(void)
+{
+    fprintf(stderr,
+            "Usage: crcsum [-a ALGORITHM] [-j JOBS] [-c [-q]] [FILE]...\n"
+            "Print or check CRC checksums (sha256sum-compatible format).\n"
+            "With no FILE, or when FILE is -, read standard input.\n\n"
+            "  -a ALGORITHM  CRC algorithm, e.g. CRC-32C, MODBUS (default %s)\n"
+            "  -j JOBS       files hashed concurrently (default: CPU count)\n"
+            "  -c            read checksums from the FILEs and check them\n"
+            "  -q            with -c, don't print OK for each verified file\n"
+            "  -l            list supported algorithms\n",
+            crc_get_name(CRCSUM_DEFAULT_TYPE));
+}
+
+static unsigned _cpu_count(void)
+{
+#if defined(_SC_NPROCESSORS_ONLN)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n > 0) {
+        return (unsigned)n;
+    }
+#endif
+    return 4;
+}
+
+int main(int argc, char **argv)
+{
+    crcsum_opts_t opts = { .type = CRCSUM_DEFAULT_TYPE, .jobs = 0, .check = 0, .quiet = 0 };
+    char *stdin_arg[] = { "-" };
+    char **files = NULL;
+    int nfiles = 0;
+    int i;
+
+    for (i = 1; i < argc && argv[i][0] == '-' && argv[i][1] != '\0'; i++) {
+        const char *arg = argv[i];
+
+        if (strcmp(arg, "--") == 0) {
+            i++;
+            break;
+        } else if (strcmp(arg, "-a") == 0 && i + 1 < argc) {
+            if (crc_get_type_by_name(argv[++i], &opts.type) != 0) {
+                fprintf(stderr, "crcsum: unknown algorithm '%s' (see crcsum -l)\n", argv[i]);
+                return 2;
+            }
+        } else if (strcmp(arg, "-j") == 0 && i + 1 < argc) {
+            opts.jobs = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "-c") == 0) {
+            opts.check = 1;
+        } else if (strcmp(arg, "-q") == 0) {
+            opts.quiet = 1;
+        } else if (strcmp(arg, "-l") == 0) {
+            for (int t = CRC_8; t <= CRC_64_JONES; t++) {
+                printf("%s\n", crc_get_name((crc_type_t)t));
+            }
+            return 0;
+        } else {
+            _usage();
+            return 2;
+        }
+    }
+
+    files = (i < argc) ? &argv[i] : stdin_arg;
+    nfiles = (i < argc) ? argc - i : 1;
+
+    if (opts.jobs == 0) {
+        opts.jobs = _cpu_count();
+    }
+    if (opts.jobs > CRCSUM_MAX_JOBS) {
+        opts.jobs = CRCSUM_MAX_JOBS;
+    }
+
+    crcsum_job_t *items = NULL;
+    size_t count = 0, cap = 0, bad_lines = 0;
+    int status = 0;
+
+    if (opts.check) {
+        for (int k = 0; k < nfiles; k++) {
+            if (_load_check_file(files[k], &items, &count, &cap, &bad_lines) != 0) {
+                status = 1;
+            }
+        }
+        if (count == 0 && bad_lines == 0 && status == 0) {
+            fprintf(stderr, "crcsum: no properly formatted checksum lines found\n");
+            status = 1;
+        }
+    } else {
+        items = calloc((size_t)nfiles, sizeof(*items));
+        if (items == NULL) {
+            fprintf(stderr, "crcsum: out of memory\n");
+            return 1;
+        }
+        for (int k = 0; k < nfiles; k++) {
+            items[k].path = files[k];
+        }
+        count = (size_t)nfiles;
+    }
+
+    size_t failed = _run(items, count, &opts);
+
+    fflush(stdout);
+    if (opts.check) {
+        if (bad_lines > 0) {
+            fprintf(stderr, "crcsum: WARNING: %zu line%s improperly formatted\n",
+                    bad_lines, bad_lines == 1 ? " is" : "s are");
+        }
+        if (failed > 0) {
+            fprintf(stderr, "crcsum: WARNING: %zu computed checksum%s did NOT match\n",
+                    failed, failed == 1 ? "" : "s");
+        }
+        for (size_t k = 0; k < count; k++) {
+            free(items[k].path);
+        }
+    }
+    free(items);
+
+    return (status != 0 || failed > 0) ? 1 : 0;
+}
@@ -20,10 +20,15 @@ extern "C" {
 
 /* Includes ------------------------------------------------------------------*/
 #include <stdint.h>
+#include "fw_ring.h"
 
 /* 导出定义 ---------------------------------------------------------------*/
 
-#define CAN_RING_BUFFER_SIZE    16      /**< CAN环形缓冲区大小 */
+#ifndef CAN_RING_BUFFER_SIZE
+#define CAN_RING_BUFFER_SIZE    16      /**< CAN环形缓冲区大小（必须为2的幂） */
+#endif
+
+_Static_assert(FW_RING_IS_POW2(CAN_RING_BUFFER_SIZE), "CAN_RING_BUFFER_SIZE must be a power of two");
 
 /* 导出类型定义 -------------------------------------------------------------*/
 
@@ -40,8 +45,7 @@ typedef struct {
 
 /* 环形缓冲区变量 - 需要在中断中访问 */
 extern fw_can_msg_t fw_can_ring_buffer[CAN_RING_BUFFER_SIZE];
-extern volatile uint16_t fw_can_ring_head;  /**< 写入位置 */
-extern volatile uint16_t fw_can_ring_tail;  /**< 读取位置 */
+extern fw_ring_t fw_can_ring;               /**< 读写位置及溢出计数 */
 extern volatile uint8_t fw_can_rx_flag;     /**< 有新消息标志 */
 
 /* 导出函数 ---------------------------------------------------------------*/
@@ -81,6 +85,13 @@ void FW_CAN_ProcessRxData(void);
  */
 void FW_CAN_SendResponse(uint32_t code, uint32_t value);
 
+/**
+ * @brief 发送CAN数据帧（ID为CAN_ID_FW_DATA_TX）
+ * @param data 数据指针
+ * @param len 数据长度（不超过8）
+ */
+void FW_CAN_SendData(const uint8_t *data, uint8_t len);
+
 /**
  * @brief 等待CAN发送完成
  */
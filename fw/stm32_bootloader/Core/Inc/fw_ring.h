@@ -0,0 +1,162 @@
+/**
+ ******************************************************************************
+ * @file    fw_ring.h
+ * @brief   单生产者单消费者(SPSC)无锁环形缓冲区索引管理
+ * @note    中断为唯一生产者、主循环为唯一消费者；容量为2的幂，
+ *          读写计数自由递增，使用掩码取槽位，满时丢弃新数据并计数
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026
+ *
+ ******************************************************************************
+ */
+
+#ifndef __FW_RING_H
+#define __FW_RING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "main.h"
+
+/* 导出宏 -----------------------------------------------------------------*/
+
+/** @brief 判断是否为2的幂（编译期检查缓冲区大小） */
+#define FW_RING_IS_POW2(n)      (((n) != 0) && (((n) & ((n) - 1)) == 0))
+
+/** @brief 静态初始化环形缓冲区控制块 */
+#define FW_RING_INIT(size)      { 0, 0, 0, 0, 0, (size) - 1 }
+
+/* 导出类型定义 -------------------------------------------------------------*/
+
+/**
+ * @brief 环形缓冲区控制块
+ * @note  数据槽由使用者自行定义，控制块只管理索引
+ */
+typedef struct {
+    volatile uint32_t head;             /**< 累计写入数（仅生产者修改） */
+    volatile uint32_t tail;             /**< 累计读取数（仅消费者修改） */
+    volatile uint32_t overflow;         /**< 缓冲区满被丢弃的帧数 */
+    volatile uint32_t gap_index;        /**< 首次丢帧时的写入位置 */
+    volatile uint8_t gap_pending;       /**< 存在尚未上报的丢帧位置 */
+    uint32_t mask;                      /**< 容量-1 */
+} fw_ring_t;
+
+/* 导出函数 ---------------------------------------------------------------*/
+
+/**
+ * @brief 复位环形缓冲区（仅在生产者未运行时调用）
+ * @param ring 控制块
+ */
+static inline void FW_Ring_Reset(fw_ring_t *ring)
+{
+    ring->head = 0;
+    ring->tail = 0;
+    ring->overflow = 0;
+    ring->gap_index = 0;
+    ring->gap_pending = 0;
+}
+
+/**
+ * @brief 生产者获取可写槽位（中断中调用）
+ * @param ring 控制块
+ * @retval 槽位索引，缓冲区满时返回-1并记录丢帧
+ * @note 满时不覆盖最旧数据，保证已接收的固件数据不被破坏
+ */
+static inline int32_t FW_Ring_ProducerSlot(fw_ring_t *ring)
+{
+    uint32_t head = ring->head;
+
+    if ((head - ring->tail) > ring->mask)
+    {
+        /* 记录第一个缺口位置，消费者读到此处时上报 */
+        if (!ring->gap_pending)
+        {
+            ring->gap_index = head;
+            ring->gap_pending = 1;
+        }
+        ring->overflow++;
+        return -1;
+    }
+
+    return (int32_t)(head & ring->mask);
+}
+
+/**
+ * @brief 生产者提交已写入的槽位
+ * @param ring 控制块
+ * @note 内存屏障保证槽位数据先于写入计数对消费者可见
+ */
+static inline void FW_Ring_ProducerCommit(fw_ring_t *ring)
+{
+    __DMB();
+    ring->head = ring->head + 1;
+}
+
+/**
+ * @brief 消费者获取可读槽位（主循环中调用）
+ * @param ring 控制块
+ * @retval 槽位索引，缓冲区空时返回-1
+ */
+static inline int32_t FW_Ring_ConsumerSlot(fw_ring_t *ring)
+{
+    uint32_t tail = ring->tail;
+
+    if (ring->head == tail)
+    {
+        return -1;
+    }
+
+    /* 先读到写入计数，再读槽位数据 */
+    __DMB();
+    return (int32_t)(tail & ring->mask);
+}
+
+/**
+ * @brief 消费者释放已读取的槽位
+ * @param ring 控制块
+ * @note 内存屏障保证槽位数据读取完成后才归还给生产者
+ */
+static inline void FW_Ring_ConsumerRelease(fw_ring_t *ring)
+{
+    __DMB();
+    ring->tail = ring->tail + 1;
+}
+
+/**
+ * @brief 消费者检查是否读到丢帧缺口
+ * @param ring 控制块
+ * @retval 1-缺口之前的数据已全部读完，之后的数据不连续 0-无缺口
+ * @note 与生产者共享gap_pending，短暂关中断避免新缺口被清除
+ */
+static inline uint8_t FW_Ring_TakeGap(fw_ring_t *ring)
+{
+    uint8_t hit = 0;
+    uint32_t primask;
+
+    if (!ring->gap_pending)
+    {
+        return 0;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (ring->gap_pending && ring->tail == ring->gap_index)
+    {
+        ring->gap_pending = 0;
+        hit = 1;
+    }
+    __set_PRIMASK(primask);
+
+    return hit;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FW_RING_H */
@@ -0,0 +1,94 @@
+/**
+ ******************************************************************************
+ * @file    fw_trace.h
+ * @brief   RAM事件追踪缓冲区头文件
+ * @note    以DWT周期计数器为时间戳记录关键事件，可通过当前传输层导出
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026
+ *
+ ******************************************************************************
+ */
+
+#ifndef __FW_TRACE_H
+#define __FW_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "main.h"
+
+/* 导出定义 ---------------------------------------------------------------*/
+
+#ifndef FW_TRACE_BUFFER_SIZE
+#define FW_TRACE_BUFFER_SIZE    512     /**< 追踪记录条数（必须为2的幂） */
+#endif
+
+#define FW_TRACE_ARG_MASK       0x00FFFFFFU  /**< 事件参数有效位（低24位） */
+
+/* 导出类型定义 -------------------------------------------------------------*/
+
+/**
+ * @brief 追踪事件类型
+ * @note  编号与上位机fw_trace.py保持一致
+ */
+typedef enum {
+    FW_TRACE_EVT_CAN_ISR = 1,           /**< CAN接收中断入口，参数为CAN ID */
+    FW_TRACE_EVT_UART_ISR,              /**< UART接收中断入口，参数为接收字节 */
+    FW_TRACE_EVT_RING_PUSH,             /**< 环形缓冲区写入，参数为写入位置 */
+    FW_TRACE_EVT_RING_POP,              /**< 环形缓冲区读取，参数为读取位置 */
+    FW_TRACE_EVT_ERASE_START,           /**< 开始擦除，参数为页数 */
+    FW_TRACE_EVT_ERASE_END,             /**< 擦除结束，参数为HAL状态 */
+    FW_TRACE_EVT_PROGRAM_START,         /**< 开始编程，参数为相对应用区的偏移 */
+    FW_TRACE_EVT_PROGRAM_END,           /**< 编程结束，参数为HAL状态 */
+    FW_TRACE_EVT_ACK_SENT               /**< 发送OFFSET/SUCCESS应答，参数为已接收字节数 */
+} fw_trace_evt_t;
+
+/**
+ * @brief 追踪记录（8字节，导出时原样发送）
+ */
+typedef struct {
+    uint32_t cycle;                     /**< DWT->CYCCNT时间戳 */
+    uint32_t info;                      /**< 高8位事件类型，低24位参数 */
+} fw_trace_record_t;
+
+/* 导出宏 -----------------------------------------------------------------*/
+
+#if BOOTLOADER_TRACE
+#define FW_TRACE(evt, arg)      FW_Trace_Record((uint8_t)(evt), (uint32_t)(arg))
+#else
+#define FW_TRACE(evt, arg)      ((void)0)
+#endif
+
+/* 导出函数 ---------------------------------------------------------------*/
+
+#if BOOTLOADER_TRACE
+/**
+ * @brief 初始化追踪模块并启动DWT周期计数器
+ */
+void FW_Trace_Init(void);
+
+/**
+ * @brief 记录一个追踪事件（可在中断中调用）
+ * @param evt 事件类型
+ * @param arg 事件参数（仅保留低24位）
+ */
+void FW_Trace_Record(uint8_t evt, uint32_t arg);
+
+/**
+ * @brief 通过传输层导出追踪记录
+ * @param clear 1-导出后清空缓冲区 0-保留
+ * @note 先发送FW_CODE_TRACE_INFO响应（记录条数），再按时间顺序发送记录
+ */
+void FW_Trace_Dump(uint8_t clear);
+#endif /* BOOTLOADER_TRACE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FW_TRACE_H */
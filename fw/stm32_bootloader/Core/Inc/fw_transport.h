@@ -0,0 +1,165 @@
+/**
+ ******************************************************************************
+ * @file    fw_transport.h
+ * @brief   传输层调用钩子
+ * @note    FW_TRANSPORT_STATIC为1时按USE_CAN_TRANSPORT在编译期绑定传输层，
+ *          钩子直接调用FW_CAN_xxx/FW_UART_xxx，可被编译器内联；
+ *          为0时经fw_transport_t函数指针运行时分发，并集中做空指针检查
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026
+ *
+ ******************************************************************************
+ */
+
+#ifndef __FW_TRANSPORT_H
+#define __FW_TRANSPORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+#include "main.h"
+#include "fw_upgrade.h"
+
+#if FW_TRANSPORT_STATIC
+
+#if USE_CAN_TRANSPORT
+#include "fw_can.h"
+
+static inline void FW_Transport_Init(void)
+{
+    FW_CAN_Init();
+}
+
+static inline void FW_Transport_ProcessRxData(void)
+{
+    FW_CAN_ProcessRxData();
+}
+
+static inline void FW_Transport_SendResponse(uint32_t code, uint32_t value)
+{
+    FW_CAN_SendResponse(code, value);
+}
+
+static inline void FW_Transport_SendData(const uint8_t *data, uint8_t len)
+{
+    FW_CAN_SendData(data, len);
+}
+
+static inline void FW_Transport_WaitTxComplete(void)
+{
+    FW_CAN_WaitTxComplete();
+}
+#else
+#include "fw_uart.h"
+
+static inline void FW_Transport_Init(void)
+{
+    FW_UART_Init();
+}
+
+static inline void FW_Transport_ProcessRxData(void)
+{
+    FW_UART_ProcessRxData();
+}
+
+static inline void FW_Transport_SendResponse(uint32_t code, uint32_t value)
+{
+    FW_UART_SendResponse(code, value);
+}
+
+static inline void FW_Transport_SendData(const uint8_t *data, uint8_t len)
+{
+    FW_UART_SendData(data, len);
+}
+
+static inline void FW_Transport_WaitTxComplete(void)
+{
+    FW_UART_WaitTxComplete();
+}
+#endif /* USE_CAN_TRANSPORT */
+
+/**
+ * @brief 传输层是否支持发送数据帧
+ * @retval 编译期绑定的传输层均支持
+ */
+static inline uint8_t FW_Transport_HasSendData(void)
+{
+    return 1;
+}
+
+#else /* !FW_TRANSPORT_STATIC */
+
+static inline void FW_Transport_Init(void)
+{
+    const fw_transport_t *transport = FW_GetTransport();
+
+    if (transport != NULL && transport->init != NULL)
+    {
+        transport->init();
+    }
+}
+
+static inline void FW_Transport_ProcessRxData(void)
+{
+    const fw_transport_t *transport = FW_GetTransport();
+
+    if (transport != NULL && transport->process_rx_data != NULL)
+    {
+        transport->process_rx_data();
+    }
+}
+
+static inline void FW_Transport_SendResponse(uint32_t code, uint32_t value)
+{
+    const fw_transport_t *transport = FW_GetTransport();
+
+    if (transport != NULL && transport->send_response != NULL)
+    {
+        transport->send_response(code, value);
+    }
+}
+
+static inline void FW_Transport_SendData(const uint8_t *data, uint8_t len)
+{
+    const fw_transport_t *transport = FW_GetTransport();
+
+    if (transport != NULL && transport->send_data != NULL)
+    {
+        transport->send_data(data, len);
+    }
+}
+
+static inline void FW_Transport_WaitTxComplete(void)
+{
+    const fw_transport_t *transport = FW_GetTransport();
+
+    if (transport != NULL && transport->wait_tx_complete != NULL)
+    {
+        transport->wait_tx_complete();
+    }
+}
+
+/**
+ * @brief 传输层是否支持发送数据帧
+ * @retval 0-不支持 1-支持
+ */
+static inline uint8_t FW_Transport_HasSendData(void)
+{
+    const fw_transport_t *transport = FW_GetTransport();
+
+    return transport != NULL && transport->send_response != NULL && transport->send_data != NULL;
+}
+
+#endif /* FW_TRANSPORT_STATIC */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FW_TRANSPORT_H */
@@ -20,10 +20,15 @@ extern "C" {
 
 /* Includes ------------------------------------------------------------------*/
 #include <stdint.h>
+#include "fw_ring.h"
 
 /* 导出定义 ---------------------------------------------------------------*/
 
-#define UART_RING_BUFFER_SIZE    128     /**< UART环形缓冲区大小 */
+#ifndef UART_RING_BUFFER_SIZE
+#define UART_RING_BUFFER_SIZE    128     /**< UART环形缓冲区大小（必须为2的幂） */
+#endif
+
+_Static_assert(FW_RING_IS_POW2(UART_RING_BUFFER_SIZE), "UART_RING_BUFFER_SIZE must be a power of two");
 
 /* UART协议帧格式定义 */
 #define UART_FRAME_HEAD          0xAA    /**< 帧头 */
@@ -61,8 +66,7 @@ typedef struct {
 
 /* 环形缓冲区变量 - 需要在中断中访问 */
 extern fw_uart_frame_t fw_uart_ring_buffer[UART_RING_BUFFER_SIZE];
-extern volatile uint16_t fw_uart_ring_head;   /**< 写入位置 */
-extern volatile uint16_t fw_uart_ring_tail;   /**< 读取位置 */
+extern fw_ring_t fw_uart_ring;                /**< 读写位置及溢出计数 */
 extern volatile uint8_t fw_uart_rx_flag;      /**< 有新帧标志 */
 
 /* 导出函数 ---------------------------------------------------------------*/
@@ -102,6 +106,13 @@ void FW_UART_ProcessRxData(void);
  */
 void FW_UART_SendResponse(uint32_t code, uint32_t value);
 
+/**
+ * @brief 发送UART数据帧（类型为UART_FRAME_DATA）
+ * @param data 数据指针
+ * @param len 数据长度（不超过8）
+ */
+void FW_UART_SendData(const uint8_t *data, uint8_t len);
+
 /**
  * @brief 等待UART发送完成
  */
@@ -25,13 +25,16 @@ extern "C" {
 
 /**
  * @brief 传输层接口结构体
- * @note  所有传输方式（CAN/UART等）都需要实现此接口
+ * @note  所有传输方式（CAN/UART等）都需要实现此接口；
+ *        FW_TRANSPORT_STATIC为1时升级核心经fw_transport.h直接调用对应实现，
+ *        此结构体仅提供名称并作为已初始化标志
  */
 typedef struct {
     const char *name;                    /**< 传输方式名称，如"CAN"、"UART" */
     void (*init)(void);                  /**< 初始化传输层 */
     void (*process_rx_data)(void);       /**< 处理接收数据（主循环中调用） */
     void (*send_response)(uint32_t code, uint32_t value); /**< 发送响应 */
+    void (*send_data)(const uint8_t *data, uint8_t len);  /**< 发送数据帧（用于追踪导出等批量数据） */
     void (*wait_tx_complete)(void);      /**< 等待发送完成 */
 } fw_transport_t;
 
@@ -60,6 +63,20 @@ void FW_ProcessFirmwareData(uint8_t *data, uint8_t len);
  */
 void FW_ProcessCommand(uint8_t *data, uint8_t len);
 
+/**
+ * @brief 上报接收缓冲区丢帧
+ * @param overflow_count 累计丢帧数
+ * @note 由传输层在读到丢帧位置时调用，升级中将进入重同步状态，
+ *       丢弃后续数据并发送FW_CODE_RX_OVERFLOW，等待上位机FW_CMD_RESUME
+ */
+void FW_NotifyRxOverflow(uint32_t overflow_count);
+
+/**
+ * @brief 固件升级模块轮询（主循环中调用）
+ * @note 在发送窗口允许时继续推送Flash回读数据
+ */
+void FW_Upgrade_Poll(void);
+
 /**
  * @brief 启动固件升级流程
  * @retval 0-失败 1-成功
@@ -82,12 +82,18 @@ void JumpToApp(uint32_t app_addr);
 #define CAN_ID_PLATFORM_RX        0x101       /* 接收上位机命令 */
 #define CAN_ID_PLATFORM_TX        0x102       /* 发送给上位机响应 */
 #define CAN_ID_FW_DATA_RX         0x103       /* 接收固件数据 */
+#define CAN_ID_FW_DATA_TX         0x104       /* 发送数据帧(追踪导出等) */
 
 /* 固件命令码 */
 #define FW_CMD_START_UPDATE       0           /* 开始升级 */
 #define FW_CMD_CONFIRM            1           /* 确认升级 */
 #define FW_CMD_VERSION            2           /* 获取版本 */
 #define FW_CMD_REBOOT             3           /* 重启 */
+#define FW_CMD_TRACE_DUMP         4           /* 导出追踪记录，参数1表示导出后清空 */
+#define FW_CMD_RESUME             5           /* 丢帧后从指定偏移恢复传输 */
+#define FW_CMD_READ_FLASH         6           /* 回读应用区，参数为长度(0为整个应用区) */
+#define FW_CMD_READ_ACK           7           /* 回读确认，参数为上位机已接收字节数 */
+#define FW_CMD_READ_RESUME        8           /* 回读CRC错误后从指定偏移重发，参数为上位机已校验字节数 */
 
 /* 固件响应码 */
 #define FW_CODE_OFFSET            0           /* 偏移响应 */
@@ -96,6 +102,12 @@ void JumpToApp(uint32_t app_addr);
 #define FW_CODE_CONFIRM           3           /* 确认响应 */
 #define FW_CODE_FLASH_ERROR       4           /* Flash错误 */
 #define FW_CODE_TRANFER_ERROR     5           /* 传输错误 */
+#define FW_CODE_TRACE_INFO        6           /* 追踪记录条数，随后为数据帧 */
+#define FW_CODE_RX_OVERFLOW       7           /* 接收缓冲区溢出，参数为需重传的偏移 */
+#define FW_CODE_READ_INFO         8           /* 回读开始，参数为回读总长度 */
+#define FW_CODE_READ_CRC          9           /* 回读块结束，参数为该块CRC-32 */
+#define FW_CODE_READ_DONE         10          /* 回读完成，参数为回读总长度 */
+#define FW_CODE_READ_OFFSET       11          /* 回读重发，参数为随后数据的起始偏移 */
 
 /* 应用固件跳转地址 */
 #define APP_START_ADDR            0x08010000
@@ -104,14 +116,28 @@ void JumpToApp(uint32_t app_addr);
 #define BOOTLOADER_VERSION        ((1 << 24) | (0 << 16) | (0 << 8)) /* v1.0.0 */
 
 /* 调试日志控制 */
+#ifndef BOOTLOADER_DEBUG_LOG
 #define BOOTLOADER_DEBUG_LOG      1    /* 1-启用日志 0-禁用日志 */
+#endif
+
+/* 事件追踪控制 */
+#ifndef BOOTLOADER_TRACE
+#define BOOTLOADER_TRACE          0    /* 1-启用RAM事件追踪 0-禁用 */
+#endif
 
+#ifndef USE_CAN_TRANSPORT
 #if BOOTLOADER_DEBUG_LOG
 /* 传输层选择 */
 #define USE_CAN_TRANSPORT         1    /* 启用日志时可选择传输层 */
 #else
 #define USE_CAN_TRANSPORT         0    /* 禁用日志时强制使用UART传输层 */
 #endif
+#endif
+
+/* 传输层绑定方式 */
+#ifndef FW_TRANSPORT_STATIC
+#define FW_TRANSPORT_STATIC       1    /* 1-编译期绑定传输层 0-经fw_transport_t运行时分发 */
+#endif
 /* USER CODE END Private defines */
 
 #ifdef __cplusplus
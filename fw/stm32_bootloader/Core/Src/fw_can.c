@@ -14,6 +14,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "fw_can.h"
 #include "fw_upgrade.h"
+#include "fw_trace.h"
 #include "main.h"
 #include "can.h"
 #include "usart.h"
@@ -23,8 +24,7 @@
 
 /* CAN环形缓冲区 */
 fw_can_msg_t fw_can_ring_buffer[CAN_RING_BUFFER_SIZE];
-volatile uint16_t fw_can_ring_head = 0;  /* 写入位置 */
-volatile uint16_t fw_can_ring_tail = 0;  /* 读取位置 */
+fw_ring_t fw_can_ring = FW_RING_INIT(CAN_RING_BUFFER_SIZE);
 volatile uint8_t fw_can_rx_flag = 0;     /* 有新消息标志 */
 
 /* 私有函数声明 -----------------------------------------------------------*/
@@ -40,28 +40,26 @@ volatile uint8_t fw_can_rx_flag = 0;     /* 有新消息标志 */
  */
 uint8_t FW_CAN_RingBuffer_Write_FromIRQ(uint32_t id, uint8_t *data, uint8_t len)
 {
-    uint16_t next_head;
+    fw_can_msg_t *msg;
+    int32_t slot;
 
-    /* 计算下一个写入位置 */
-    next_head = (fw_can_ring_head + 1) % CAN_RING_BUFFER_SIZE;
-
-    /* 检查缓冲区是否已满 */
-    if (next_head == fw_can_ring_tail)
+    /* 获取写入位置，缓冲区满时丢弃新消息并计数，由主循环上报 */
+    slot = FW_Ring_ProducerSlot(&fw_can_ring);
+    if (slot < 0)
     {
-        /* 缓冲区满，丢弃最旧的消息 */
-        fw_can_ring_tail = (fw_can_ring_tail + 1) % CAN_RING_BUFFER_SIZE;
+        return 0;
     }
 
     /* 写入消息 */
-    fw_can_ring_buffer[fw_can_ring_head].id = id;
-    fw_can_ring_buffer[fw_can_ring_head].len = len;
-    for (uint8_t i = 0; i < len; i++)
-    {
-        fw_can_ring_buffer[fw_can_ring_head].data[i] = data[i];
-    }
+    msg = &fw_can_ring_buffer[slot];
+    msg->id = id;
+    msg->len = (len > 8) ? 8 : len;
+    memcpy(msg->data, data, msg->len);
+
+    FW_TRACE(FW_TRACE_EVT_RING_PUSH, slot);
 
     /* 更新写入位置 */
-    fw_can_ring_head = next_head;
+    FW_Ring_ProducerCommit(&fw_can_ring);
 
     return 1;
 }
@@ -75,22 +73,24 @@ uint8_t FW_CAN_RingBuffer_Write_FromIRQ(uint32_t id, uint8_t *data, uint8_t len)
  */
 uint8_t FW_CAN_RingBuffer_Read(uint32_t *id, uint8_t *data, uint8_t *len)
 {
+    int32_t slot;
+
     /* 检查缓冲区是否为空 */
-    if (fw_can_ring_head == fw_can_ring_tail)
+    slot = FW_Ring_ConsumerSlot(&fw_can_ring);
+    if (slot < 0)
     {
         return 0;
     }
 
     /* 读取消息 */
-    *id = fw_can_ring_buffer[fw_can_ring_tail].id;
-    *len = fw_can_ring_buffer[fw_can_ring_tail].len;
-    for (uint8_t i = 0; i < *len; i++)
-    {
-        data[i] = fw_can_ring_buffer[fw_can_ring_tail].data[i];
-    }
+    *id = fw_can_ring_buffer[slot].id;
+    *len = fw_can_ring_buffer[slot].len;
+    memcpy(data, fw_can_ring_buffer[slot].data, *len);
+
+    FW_TRACE(FW_TRACE_EVT_RING_POP, slot);
 
     /* 更新读取位置 */
-    fw_can_ring_tail = (fw_can_ring_tail + 1) % CAN_RING_BUFFER_SIZE;
+    FW_Ring_ConsumerRelease(&fw_can_ring);
 
     return 1;
 }
@@ -154,8 +154,19 @@ void FW_CAN_ProcessRxData(void)
     uint8_t data[8];
     uint8_t len;
 
-    while (FW_CAN_RingBuffer_Read(&id, data, &len))
+    for (;;)
     {
+        /* 读到丢帧位置，之后的固件数据不再连续 */
+        if (FW_Ring_TakeGap(&fw_can_ring))
+        {
+            FW_NotifyRxOverflow(fw_can_ring.overflow);
+        }
+
+        if (!FW_CAN_RingBuffer_Read(&id, data, &len))
+        {
+            break;
+        }
+
         if (id == CAN_ID_PLATFORM_RX)
         {
             /* 处理命令 */
@@ -209,6 +220,43 @@ void FW_CAN_SendResponse(uint32_t code, uint32_t value)
     }
 }
 
+/**
+ * @brief 发送CAN数据帧（ID为CAN_ID_FW_DATA_TX）
+ * @param data 数据指针
+ * @param len 数据长度（不超过8）
+ */
+void FW_CAN_SendData(const uint8_t *data, uint8_t len)
+{
+    CAN_TxHeaderTypeDef tx_header;
+    uint8_t tx_data[8] = {0};
+    uint32_t tx_mailbox;
+
+    if (len > 8)
+    {
+        len = 8;
+    }
+    memcpy(tx_data, data, len);
+
+    /* 配置CAN发送头 */
+    tx_header.StdId = CAN_ID_FW_DATA_TX;
+    tx_header.ExtId = 0;
+    tx_header.IDE = CAN_ID_STD;
+    tx_header.RTR = CAN_RTR_DATA;
+    tx_header.DLC = len;
+    tx_header.TransmitGlobalTime = DISABLE;
+
+    /* 等待空闲邮箱
+     * 数据帧共用同一ID，依赖TXFP（can.c中TransmitFifoPriority=ENABLE）按提交顺序发出，
+     * 否则同ID帧按邮箱号发送，上位机收到的数据会乱序 */
+    while (HAL_CAN_GetTxMailboxesFreeLevel(&hcan) == 0);
+
+    if (HAL_CAN_AddTxMessage(&hcan, &tx_header, tx_data, &tx_mailbox) != HAL_OK)
+    {
+        Log_printf("[ERROR] CAN data send failed!\r\n");
+        Error_Handler();
+    }
+}
+
 /**
  * @brief 等待CAN发送完成
  */
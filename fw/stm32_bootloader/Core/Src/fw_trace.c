@@ -0,0 +1,117 @@
+/**
+ ******************************************************************************
+ * @file    fw_trace.c
+ * @brief   RAM事件追踪缓冲区实现
+ * @note    固定大小环形缓冲区，满时覆盖最旧记录
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "fw_trace.h"
+#include "fw_transport.h"
+#include "usart.h"
+
+#if BOOTLOADER_TRACE
+
+/* 私有定义 ---------------------------------------------------------------*/
+
+#if (FW_TRACE_BUFFER_SIZE & (FW_TRACE_BUFFER_SIZE - 1)) != 0
+#error "FW_TRACE_BUFFER_SIZE must be a power of two"
+#endif
+
+#define FW_TRACE_INDEX_MASK     (FW_TRACE_BUFFER_SIZE - 1)
+
+/* 私有变量 ---------------------------------------------------------------*/
+
+static fw_trace_record_t trace_buffer[FW_TRACE_BUFFER_SIZE];
+static volatile uint32_t trace_head = 0;      /* 累计写入条数（自由递增） */
+static volatile uint8_t trace_enabled = 0;    /* 导出期间暂停记录 */
+
+/* 导出函数 ---------------------------------------------------------------*/
+
+/**
+ * @brief 初始化追踪模块并启动DWT周期计数器
+ */
+void FW_Trace_Init(void)
+{
+    /* 使能DWT并清零周期计数器 */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    trace_head = 0;
+    trace_enabled = 1;
+
+    Log_printf("[TRACE] Enabled, %d records\r\n", FW_TRACE_BUFFER_SIZE);
+}
+
+/**
+ * @brief 记录一个追踪事件（可在中断中调用）
+ * @param evt 事件类型
+ * @param arg 事件参数（仅保留低24位）
+ */
+void FW_Trace_Record(uint8_t evt, uint32_t arg)
+{
+    fw_trace_record_t *record;
+    uint32_t primask;
+
+    if (!trace_enabled)
+    {
+        return;
+    }
+
+    /* 主循环与中断都会写入，短临界区保证记录完整 */
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    record = &trace_buffer[trace_head & FW_TRACE_INDEX_MASK];
+    record->cycle = DWT->CYCCNT;
+    record->info = ((uint32_t)evt << 24) | (arg & FW_TRACE_ARG_MASK);
+    trace_head++;
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 通过传输层导出追踪记录
+ * @param clear 1-导出后清空缓冲区 0-保留
+ * @note 先发送FW_CODE_TRACE_INFO响应（记录条数），再按时间顺序发送记录
+ */
+void FW_Trace_Dump(uint8_t clear)
+{
+    uint32_t count;
+    uint32_t start;
+
+    /* 导出期间暂停记录，避免发送过程本身污染时间线 */
+    trace_enabled = 0;
+
+    count = (trace_head < FW_TRACE_BUFFER_SIZE) ? trace_head : FW_TRACE_BUFFER_SIZE;
+    if (!FW_Transport_HasSendData())
+    {
+        count = 0;
+    }
+    start = trace_head - count;
+
+    Log_printf("[TRACE] Dump %d records\r\n", count);
+    FW_Transport_SendResponse(FW_CODE_TRACE_INFO, count);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        FW_Transport_SendData((const uint8_t *)&trace_buffer[(start + i) & FW_TRACE_INDEX_MASK],
+                              sizeof(fw_trace_record_t));
+    }
+
+    if (clear)
+    {
+        trace_head = 0;
+    }
+
+    trace_enabled = 1;
+}
+
+#endif /* BOOTLOADER_TRACE */
@@ -14,16 +14,17 @@
 /* Includes ------------------------------------------------------------------*/
 #include "fw_uart.h"
 #include "fw_upgrade.h"
+#include "fw_trace.h"
 #include "main.h"
 #include "usart.h"
+#include "crc_nibble.h"
 #include <string.h>
 
 /* 私有定义 ---------------------------------------------------------------*/
 
 /* UART环形缓冲区 */
 fw_uart_frame_t fw_uart_ring_buffer[UART_RING_BUFFER_SIZE];
-volatile uint16_t fw_uart_ring_head = 0;   /* 写入位置 */
-volatile uint16_t fw_uart_ring_tail = 0;   /* 读取位置 */
+fw_ring_t fw_uart_ring = FW_RING_INIT(UART_RING_BUFFER_SIZE);
 volatile uint8_t fw_uart_rx_flag = 0;      /* 有新帧标志 */
 
 /* 私有变量 ---------------------------------------------------------------*/
@@ -37,8 +38,8 @@ static uint16_t uart_rx_crc = 0;           /* 接收的CRC */
 
 /* 私有函数声明 -----------------------------------------------------------*/
 
-static uint16_t UART_CalcCRC16(uint8_t *data, uint16_t len);
-static void UART_SendFrame(uint8_t type, uint8_t *data, uint8_t len);
+static uint16_t UART_CalcCRC16(const uint8_t *data, uint16_t len);
+static void UART_SendFrame(uint8_t type, const uint8_t *data, uint8_t len);
 
 /* 导出函数 ---------------------------------------------------------------*/
 
@@ -51,25 +52,26 @@ static void UART_SendFrame(uint8_t type, uint8_t *data, uint8_t len);
  */
 uint8_t FW_UART_RingBuffer_Write_FromIRQ(uint8_t type, uint8_t *data, uint8_t len)
 {
-    uint16_t next_head;
+    fw_uart_frame_t *frame;
+    int32_t slot;
 
-    /* 计算下一个写入位置 */
-    next_head = (fw_uart_ring_head + 1) % UART_RING_BUFFER_SIZE;
-
-    /* 检查缓冲区是否已满 */
-    if (next_head == fw_uart_ring_tail)
+    /* 获取写入位置，缓冲区满时丢弃新帧并计数，由主循环上报 */
+    slot = FW_Ring_ProducerSlot(&fw_uart_ring);
+    if (slot < 0)
     {
-        /* 缓冲区满，丢弃最旧的消息 */
-        fw_uart_ring_tail = (fw_uart_ring_tail + 1) % UART_RING_BUFFER_SIZE;
+        return 0;
     }
 
     /* 写入消息 */
-    fw_uart_ring_buffer[fw_uart_ring_head].type = type;
-    fw_uart_ring_buffer[fw_uart_ring_head].len = len;
-    memcpy(fw_uart_ring_buffer[fw_uart_ring_head].data, data, len);
+    frame = &fw_uart_ring_buffer[slot];
+    frame->type = type;
+    frame->len = len;
+    memcpy(frame->data, data, len);
+
+    FW_TRACE(FW_TRACE_EVT_RING_PUSH, slot);
 
     /* 更新写入位置 */
-    fw_uart_ring_head = next_head;
+    FW_Ring_ProducerCommit(&fw_uart_ring);
 
     return 1;
 }
@@ -83,19 +85,24 @@ uint8_t FW_UART_RingBuffer_Write_FromIRQ(uint8_t type, uint8_t *data, uint8_t le
  */
 uint8_t FW_UART_RingBuffer_Read(uint8_t *type, uint8_t *data, uint8_t *len)
 {
+    int32_t slot;
+
     /* 检查缓冲区是否为空 */
-    if (fw_uart_ring_head == fw_uart_ring_tail)
+    slot = FW_Ring_ConsumerSlot(&fw_uart_ring);
+    if (slot < 0)
     {
         return 0;
     }
 
     /* 读取消息 */
-    *type = fw_uart_ring_buffer[fw_uart_ring_tail].type;
-    *len = fw_uart_ring_buffer[fw_uart_ring_tail].len;
-    memcpy(data, fw_uart_ring_buffer[fw_uart_ring_tail].data, *len);
+    *type = fw_uart_ring_buffer[slot].type;
+    *len = fw_uart_ring_buffer[slot].len;
+    memcpy(data, fw_uart_ring_buffer[slot].data, *len);
+
+    FW_TRACE(FW_TRACE_EVT_RING_POP, slot);
 
     /* 更新读取位置 */
-    fw_uart_ring_tail = (fw_uart_ring_tail + 1) % UART_RING_BUFFER_SIZE;
+    FW_Ring_ConsumerRelease(&fw_uart_ring);
 
     return 1;
 }
@@ -113,8 +120,7 @@ void FW_UART_Init(void)
     uart_rx_crc = 0;
 
     /* 清空环形缓冲区 */
-    fw_uart_ring_head = 0;
-    fw_uart_ring_tail = 0;
+    FW_Ring_Reset(&fw_uart_ring);
     fw_uart_rx_flag = 0;
 
     /* 启动UART接收中断 */
@@ -142,8 +148,19 @@ void FW_UART_ProcessRxData(void)
     uint8_t data[8];
     uint8_t len;
 
-    while (FW_UART_RingBuffer_Read(&type, data, &len))
+    for (;;)
     {
+        /* 读到丢帧位置，之后的固件数据不再连续 */
+        if (FW_Ring_TakeGap(&fw_uart_ring))
+        {
+            FW_NotifyRxOverflow(fw_uart_ring.overflow);
+        }
+
+        if (!FW_UART_RingBuffer_Read(&type, data, &len))
+        {
+            break;
+        }
+
         if (type == UART_FRAME_CMD)
         {
             /* 处理命令 */
@@ -180,6 +197,21 @@ void FW_UART_SendResponse(uint32_t code, uint32_t value)
     }
 }
 
+/**
+ * @brief 发送UART数据帧（类型为UART_FRAME_DATA）
+ * @param data 数据指针
+ * @param len 数据长度（不超过8）
+ */
+void FW_UART_SendData(const uint8_t *data, uint8_t len)
+{
+    if (len > 8)
+    {
+        len = 8;
+    }
+
+    UART_SendFrame(UART_FRAME_DATA, data, len);
+}
+
 /**
  * @brief 等待UART发送完成
  */
@@ -263,7 +295,7 @@ void FW_UART_RxCallback(uint8_t byte)
                 uint16_t calc_crc = UART_CalcCRC16(uart_rx_buffer, uart_rx_len);
                 if (calc_crc == uart_rx_crc)
                 {
-                    /* CRC正确，写入环形缓冲区 */
+                    /* CRC正确，写入环形缓冲区（满时由主循环上报丢帧） */
                     FW_UART_RingBuffer_Write_FromIRQ(uart_rx_type, uart_rx_buffer, uart_rx_len);
                     fw_uart_rx_flag = 1;
                 }
@@ -288,33 +320,15 @@ void FW_UART_RxCallback(uint8_t byte)
 /* 私有函数 ---------------------------------------------------------------*/
 
 /**
- * @brief 计算CRC16-CCITT
+ * @brief 计算帧CRC16（MODBUS：反向 0xA001，初值 0xFFFF）
+ * @note  使用 crc_nibble.h 半字节查表（32字节表），在接收中断中调用
  * @param data 数据指针
  * @param len 数据长度
  * @retval CRC16值
  */
-static uint16_t UART_CalcCRC16(uint8_t *data, uint16_t len)
+static uint16_t UART_CalcCRC16(const uint8_t *data, uint16_t len)
 {
-    uint16_t crc = 0xFFFF;
-    uint16_t i;
-
-    for (i = 0; i < len; i++)
-    {
-        crc ^= (uint16_t)data[i];
-        for (uint8_t j = 0; j < 8; j++)
-        {
-            if (crc & 0x0001)
-            {
-                crc = (crc >> 1) ^ 0xA001;
-            }
-            else
-            {
-                crc >>= 1;
-            }
-        }
-    }
-
-    return crc;
+    return crc16_modbus_nibble(data, len);
 }
 
 /**
@@ -323,7 +337,7 @@ static uint16_t UART_CalcCRC16(uint8_t *data, uint16_t len)
  * @param data 数据指针
  * @param len 数据长度
  */
-static void UART_SendFrame(uint8_t type, uint8_t *data, uint8_t len)
+static void UART_SendFrame(uint8_t type, const uint8_t *data, uint8_t len)
 {
     uint8_t frame[32];
     uint16_t crc;
@@ -13,13 +13,19 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "fw_upgrade.h"
+#include "fw_transport.h"
+#include "fw_trace.h"
 #include "main.h"
 #include "usart.h"
+#include "crc_nibble.h"
 #include <string.h>
 
 /* 私有定义 ---------------------------------------------------------------*/
 
 #define FLASH_BUFFER_SIZE      64    /**< Flash写入缓冲区大小 */
+#define READ_BLOCK_SIZE        256   /**< 回读块大小，每块附带一个CRC-32 */
+#define READ_WINDOW_BLOCKS     4     /**< 回读窗口：未确认的最大块数 */
+#define READ_ACK_TIMEOUT_MS    500   /**< 回读确认超时，超时后从已确认位置重发 */
 
 /* 私有变量 ---------------------------------------------------------------*/
 
@@ -38,12 +44,22 @@ static uint32_t current_flash_addr = FLASH_APP_START_ADDR;
 static uint32_t total_fw_size = 0;
 static uint32_t received_fw_size = 0;
 static uint8_t is_upgrading = 0;
+static uint8_t rx_resync = 0;      /* 丢帧后等待上位机重传 */
+
+/* Flash回读状态 */
+static uint8_t is_reading = 0;
+static uint32_t read_total_size = 0;
+static uint32_t read_sent_size = 0;
+static uint32_t read_acked_size = 0;
+static uint32_t read_ack_tick = 0;     /* 最近一次确认推进或重发的时刻 */
 
 /* 私有函数声明 -----------------------------------------------------------*/
 
 static HAL_StatusTypeDef Flash_EraseAppArea(uint32_t firmware_size);
 static HAL_StatusTypeDef Flash_WriteData(uint32_t start_addr, uint8_t *data, uint32_t len);
 static uint32_t Flash_ReadWord(uint32_t addr);
+static uint32_t FW_CalcCRC32(const uint8_t *data, uint32_t len);
+static void FW_ReadRewind(uint32_t offset);
 
 /* 导出函数 ---------------------------------------------------------------*/
 
@@ -64,11 +80,12 @@ uint8_t FW_Upgrade_Init(const fw_transport_t *transport)
 
     Log_printf("[FW_UP] Init with transport: %s\r\n", transport->name);
 
+#if BOOTLOADER_TRACE
+    FW_Trace_Init();
+#endif
+
     /* 初始化传输层 */
-    if (g_transport->init != NULL)
-    {
-        g_transport->init();
-    }
+    FW_Transport_Init();
 
     return 1;
 }
@@ -81,6 +98,12 @@ uint8_t FW_Upgrade_Init(const fw_transport_t *transport)
  */
 void FW_ProcessFirmwareData(uint8_t *data, uint8_t len)
 {
+    /* 丢帧后到收到RESUME之前的数据均不连续，直接丢弃 */
+    if (rx_resync)
+    {
+        return;
+    }
+
     if (received_fw_size >= total_fw_size)
     {
         Log_printf("[WARNING] Extra data: recv=%d, total=%d\r\n", received_fw_size, total_fw_size);
@@ -99,10 +122,7 @@ void FW_ProcessFirmwareData(uint8_t *data, uint8_t len)
             if (Flash_WriteData(current_flash_addr, flash_buffer, flash_buffer_index) != HAL_OK)
             {
                 Log_printf("[ERROR] Flash write failed at %08X\r\n", current_flash_addr);
-                if (g_transport->send_response != NULL)
-                {
-                    g_transport->send_response(FW_CODE_FLASH_ERROR, received_fw_size);
-                }
+                FW_Transport_SendResponse(FW_CODE_FLASH_ERROR, received_fw_size);
                 return;
             }
 
@@ -120,17 +140,13 @@ void FW_ProcessFirmwareData(uint8_t *data, uint8_t len)
             {
                 Log_printf("[FLASH] Firmware write complete!\r\n");
                 is_upgrading = 0;  /* 升级完成 */
-                if (g_transport->send_response != NULL)
-                {
-                    g_transport->send_response(FW_CODE_UPDATE_SUCCESS, received_fw_size);
-                }
+                FW_Transport_SendResponse(FW_CODE_UPDATE_SUCCESS, received_fw_size);
+                FW_TRACE(FW_TRACE_EVT_ACK_SENT, received_fw_size);
             }
             else
             {
-                if (g_transport->send_response != NULL)
-                {
-                    g_transport->send_response(FW_CODE_OFFSET, received_fw_size);
-                }
+                FW_Transport_SendResponse(FW_CODE_OFFSET, received_fw_size);
+                FW_TRACE(FW_TRACE_EVT_ACK_SENT, received_fw_size);
             }
         }
     }
@@ -170,22 +186,18 @@ void FW_ProcessCommand(uint8_t *data, uint8_t len)
                 current_flash_addr = FLASH_APP_START_ADDR;
                 flash_buffer_index = 0;
                 is_upgrading = 1;
+                rx_resync = 0;
+                is_reading = 0;
 
                 Log_printf("[CMD] Start update: firmware size = %d bytes\r\n", total_fw_size);
 
-                if (g_transport->send_response != NULL)
-                {
-                    g_transport->send_response(FW_CODE_OFFSET, 0);
-                }
+                FW_Transport_SendResponse(FW_CODE_OFFSET, 0);
                 HAL_GPIO_WritePin(LED1_GPIO_Port, LED1_Pin, GPIO_PIN_SET);
             }
             else
             {
                 Log_printf("[ERROR] Flash erase failed!\r\n");
-                if (g_transport->send_response != NULL)
-                {
-                    g_transport->send_response(FW_CODE_FLASH_ERROR, 0);
-                }
+                FW_Transport_SendResponse(FW_CODE_FLASH_ERROR, 0);
             }
             break;
         }
@@ -201,10 +213,7 @@ void FW_ProcessCommand(uint8_t *data, uint8_t len)
                 if (VerifyAppFirmware())
                 {
                     Log_printf("[CMD] Firmware verified OK, jumping to app...\r\n");
-                    if (g_transport->send_response != NULL)
-                    {
-                        g_transport->send_response(FW_CODE_CONFIRM, 0x55AA55AA);
-                    }
+                    FW_Transport_SendResponse(FW_CODE_CONFIRM, 0x55AA55AA);
                     /* 等待发送完成 */
                     FW_WaitTxComplete();
                     /* 跳转到应用 */
@@ -213,20 +222,14 @@ void FW_ProcessCommand(uint8_t *data, uint8_t len)
                 else
                 {
                     Log_printf("[ERROR] Firmware verify failed!\r\n");
-                    if (g_transport->send_response != NULL)
-                    {
-                        g_transport->send_response(FW_CODE_FLASH_ERROR, 0);
-                    }
+                    FW_Transport_SendResponse(FW_CODE_FLASH_ERROR, 0);
                 }
             }
             else
             {
                 /* 测试模式，不启动应用 */
                 Log_printf("[CMD] Test mode, not starting app\r\n");
-                if (g_transport->send_response != NULL)
-                {
-                    g_transport->send_response(FW_CODE_CONFIRM, 0x55AA55AA);
-                }
+                FW_Transport_SendResponse(FW_CODE_CONFIRM, 0x55AA55AA);
             }
             break;
         }
@@ -235,10 +238,7 @@ void FW_ProcessCommand(uint8_t *data, uint8_t len)
         {
             /* 返回bootloader版本 */
             Log_printf("[CMD] Get version\r\n");
-            if (g_transport->send_response != NULL)
-            {
-                g_transport->send_response(FW_CODE_VERSION, BOOTLOADER_VERSION);
-            }
+            FW_Transport_SendResponse(FW_CODE_VERSION, BOOTLOADER_VERSION);
             break;
         }
 
@@ -251,12 +251,186 @@ void FW_ProcessCommand(uint8_t *data, uint8_t len)
             break;
         }
 
+        case FW_CMD_RESUME:
+        {
+            /* 丢帧后恢复传输，param为上位机重传的起始偏移 */
+            Log_printf("[CMD] Resume at %d (recv=%d)\r\n", param, received_fw_size);
+            if (is_upgrading && param == received_fw_size)
+            {
+                rx_resync = 0;
+                FW_Transport_SendResponse(FW_CODE_OFFSET, received_fw_size);
+            }
+            else
+            {
+                FW_Transport_SendResponse(FW_CODE_TRANFER_ERROR, received_fw_size);
+            }
+            break;
+        }
+
+        case FW_CMD_READ_FLASH:
+        {
+            /* 回读应用区，param为回读长度，0表示整个应用区 */
+            uint32_t app_size = FLASH_APP_END_ADDR - FLASH_APP_START_ADDR;
+
+            if (is_upgrading)
+            {
+                Log_printf("[ERROR] Read flash rejected while upgrading\r\n");
+                FW_Transport_SendResponse(FW_CODE_TRANFER_ERROR, 0);
+                break;
+            }
+
+            read_total_size = (param == 0 || param > app_size) ? app_size : param;
+            read_sent_size = 0;
+            read_acked_size = 0;
+            read_ack_tick = HAL_GetTick();
+            is_reading = 1;
+
+            Log_printf("[CMD] Read flash: %d bytes\r\n", read_total_size);
+            FW_Transport_SendResponse(FW_CODE_READ_INFO, read_total_size);
+            break;
+        }
+
+        case FW_CMD_READ_ACK:
+        {
+            /* 上位机确认已接收的字节数，推进发送窗口 */
+            if (is_reading && param > read_acked_size && param <= read_sent_size)
+            {
+                read_acked_size = param;
+                read_ack_tick = HAL_GetTick();
+
+                /* 全部确认后才结束，最后几块的确认丢失时仍可超时重发 */
+                if (read_acked_size >= read_total_size)
+                {
+                    Log_printf("[FLASH] Read back complete: %d bytes\r\n", read_total_size);
+                    is_reading = 0;
+                    FW_Transport_SendResponse(FW_CODE_READ_DONE, read_total_size);
+                }
+            }
+            break;
+        }
+
+        case FW_CMD_READ_RESUME:
+        {
+            /* 上位机块校验失败，从其已校验位置重发 */
+            Log_printf("[CMD] Read resume at %d (acked=%d, sent=%d)\r\n", param, read_acked_size, read_sent_size);
+            if (is_reading && param >= read_acked_size && param <= read_sent_size && param % READ_BLOCK_SIZE == 0)
+            {
+                FW_ReadRewind(param);
+            }
+            else
+            {
+                FW_Transport_SendResponse(FW_CODE_TRANFER_ERROR, read_acked_size);
+            }
+            break;
+        }
+
+        case FW_CMD_TRACE_DUMP:
+        {
+            /* 导出追踪记录，param为1则导出后清空 */
+            Log_printf("[CMD] Trace dump: clear=%d\r\n", param);
+#if BOOTLOADER_TRACE
+            FW_Trace_Dump(param == 1);
+#else
+            /* 未编译追踪功能，返回0条记录 */
+            FW_Transport_SendResponse(FW_CODE_TRACE_INFO, 0);
+#endif
+            break;
+        }
+
         default:
             Log_printf("[CMD] Unknown command: %d\r\n", cmd);
             break;
     }
 }
 
+/**
+ * @brief 上报接收缓冲区丢帧
+ * @param overflow_count 累计丢帧数
+ * @note 由传输层在读到丢帧位置时调用，升级中将进入重同步状态，
+ *       丢弃后续数据并发送FW_CODE_RX_OVERFLOW，等待上位机FW_CMD_RESUME
+ */
+void FW_NotifyRxOverflow(uint32_t overflow_count)
+{
+    Log_printf("[WARNING] RX overflow: dropped=%d, recv=%d\r\n", overflow_count, received_fw_size);
+
+    if (!is_upgrading)
+    {
+        return;
+    }
+
+    /* 请求上位机从已接收位置重传 */
+    rx_resync = 1;
+    FW_Transport_SendResponse(FW_CODE_RX_OVERFLOW, received_fw_size);
+}
+
+/**
+ * @brief 固件升级模块轮询（主循环中调用）
+ * @note 在发送窗口允许时继续推送Flash回读数据
+ */
+void FW_Upgrade_Poll(void)
+{
+    const uint8_t *block;
+    uint32_t block_len;
+
+    if (!is_reading)
+    {
+        return;
+    }
+
+    if (!FW_Transport_HasSendData())
+    {
+        is_reading = 0;
+        return;
+    }
+
+    /* 确认超时（确认帧或数据丢失），回退到已确认位置重发 */
+    if (read_sent_size > read_acked_size && HAL_GetTick() - read_ack_tick >= READ_ACK_TIMEOUT_MS)
+    {
+        Log_printf("[WARNING] Read ack timeout: acked=%d, sent=%d\r\n", read_acked_size, read_sent_size);
+        FW_ReadRewind(read_acked_size);
+    }
+
+    /* 全部发出或窗口已满，等待上位机确认 */
+    if (read_sent_size >= read_total_size ||
+        read_sent_size - read_acked_size >= READ_WINDOW_BLOCKS * READ_BLOCK_SIZE)
+    {
+        return;
+    }
+
+    /* 每次轮询发送一块，让主循环有机会处理确认 */
+    block = (const uint8_t *)(FLASH_APP_START_ADDR + read_sent_size);
+    block_len = read_total_size - read_sent_size;
+    if (block_len > READ_BLOCK_SIZE)
+    {
+        block_len = READ_BLOCK_SIZE;
+    }
+
+    for (uint32_t i = 0; i < block_len; i += 8)
+    {
+        FW_Transport_SendData(&block[i], (block_len - i >= 8) ? 8 : (uint8_t)(block_len - i));
+    }
+
+    /* READ_CRC(0x102)的ID低于数据帧(0x104)，CAN需TXFP按提交顺序发送（见can.c），
+     * 这里再等数据帧发完，避免CRC先于块尾到达上位机 */
+    FW_Transport_WaitTxComplete();
+    FW_Transport_SendResponse(FW_CODE_READ_CRC, FW_CalcCRC32(block, block_len));
+
+    read_sent_size += block_len;
+}
+
+/**
+ * @brief 回读从指定偏移重发
+ * @param offset 重发起始偏移（块对齐，不小于已确认位置）
+ * @note 先发送FW_CODE_READ_OFFSET，上位机丢弃此前未校验的数据，从该偏移重新拼块
+ */
+static void FW_ReadRewind(uint32_t offset)
+{
+    read_acked_size = offset;
+    read_sent_size = offset;
+    read_ack_tick = HAL_GetTick();
+    FW_Transport_SendResponse(FW_CODE_READ_OFFSET, offset);
+}
+
 /**
  * @brief 启动固件升级流程
  * @retval 0-失败 1-成功
@@ -264,14 +438,16 @@ void FW_ProcessCommand(uint8_t *data, uint8_t len)
 uint8_t FW_StartUpgrade(void)
 {
     is_upgrading = 0;
+    rx_resync = 0;
+    is_reading = 0;
     total_fw_size = 0;
     received_fw_size = 0;
     flash_buffer_index = 0;
     current_flash_addr = FLASH_APP_START_ADDR;
 
-    if (g_transport != NULL && g_transport->init != NULL)
+    if (g_transport != NULL)
     {
-        g_transport->init();
+        FW_Transport_Init();
         return 1;
     }
 
@@ -293,10 +469,7 @@ uint8_t FW_IsUpgrading(void)
  */
 void FW_WaitTxComplete(void)
 {
-    if (g_transport != NULL && g_transport->wait_tx_complete != NULL)
-    {
-        g_transport->wait_tx_complete();
-    }
+    FW_Transport_WaitTxComplete();
 }
 
 /**
@@ -343,7 +516,9 @@ static HAL_StatusTypeDef Flash_EraseAppArea(uint32_t firmware_size)
     erase_init.NbPages = nb_pages;
 
     /* 执行擦除 */
+    FW_TRACE(FW_TRACE_EVT_ERASE_START, nb_pages);
     status = HAL_FLASHEx_Erase(&erase_init, &page_error);
+    FW_TRACE(FW_TRACE_EVT_ERASE_END, status);
 
     /* 锁定Flash */
     HAL_FLASH_Lock();
@@ -374,6 +549,7 @@ static HAL_StatusTypeDef Flash_WriteData(uint32_t start_addr, uint8_t *data, uin
     uint32_t i;
     uint64_t data64 = 0;
 
+    FW_TRACE(FW_TRACE_EVT_PROGRAM_START, start_addr - FLASH_APP_START_ADDR);
     HAL_FLASH_Unlock();
 
     for (i = 0; i < len; i += 8)
@@ -401,6 +577,7 @@ static HAL_StatusTypeDef Flash_WriteData(uint32_t start_addr, uint8_t *data, uin
     }
 
     HAL_FLASH_Lock();
+    FW_TRACE(FW_TRACE_EVT_PROGRAM_END, status);
     return status;
 }
 
@@ -414,6 +591,18 @@ static uint32_t Flash_ReadWord(uint32_t addr)
     return *(volatile uint32_t *)addr;
 }
 
+/**
+ * @brief 计算CRC-32（与zlib.crc32一致）
+ * @param data 数据指针
+ * @param len 数据长度
+ * @retval CRC-32值
+ * @note 使用 crc_nibble.h 半字节查表（64字节表），兼顾速度和ROM占用
+ */
+static uint32_t FW_CalcCRC32(const uint8_t *data, uint32_t len)
+{
+    return crc32_nibble(data, len);
+}
+
 /**
  * @brief 验证应用固件
  * @retval 1-有效 0-无效
@@ -30,6 +30,7 @@
 #include "fw_upgrade.h"
 #include "fw_can.h"
 #include "fw_uart.h"
+#include "fw_transport.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -56,6 +57,7 @@ static const fw_transport_t can_transport = {
     .init = FW_CAN_Init,
     .process_rx_data = FW_CAN_ProcessRxData,
     .send_response = FW_CAN_SendResponse,
+    .send_data = FW_CAN_SendData,
     .wait_tx_complete = FW_CAN_WaitTxComplete
 };
 #define TRANSPORT_LAYER &can_transport
@@ -66,6 +68,7 @@ static const fw_transport_t uart_transport = {
     .init = FW_UART_Init,
     .process_rx_data = FW_UART_ProcessRxData,
     .send_response = FW_UART_SendResponse,
+    .send_data = FW_UART_SendData,
     .wait_tx_complete = FW_UART_WaitTxComplete
 };
 #define TRANSPORT_LAYER &uart_transport
@@ -160,11 +163,10 @@ int main(void)
 
     /* USER CODE BEGIN 3 */
     /* 调用传输层处理接收数据 */
-    const fw_transport_t *transport = FW_GetTransport();
-    if (transport != NULL && transport->process_rx_data != NULL)
-    {
-      transport->process_rx_data();
-    }
+    FW_Transport_ProcessRxData();
+
+    /* 推进Flash回读等后台任务 */
+    FW_Upgrade_Poll();
   }
   /* USER CODE END 3 */
 }
@@ -23,6 +23,7 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "fw_can.h"
+#include "fw_trace.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -258,6 +259,8 @@ void HAL_CAN_RxFifo1MsgPendingCallback(CAN_HandleTypeDef *hcan)
   /* 接收CAN消息 */
   if (HAL_CAN_GetRxMessage(hcan, CAN_RX_FIFO1, &rx_header, rx_data) == HAL_OK)
   {
+    FW_TRACE(FW_TRACE_EVT_CAN_ISR, rx_header.StdId);
+
     /* 写入环形缓冲区 */
     FW_CAN_RingBuffer_Write_FromIRQ(rx_header.StdId, rx_data, rx_header.DLC);
 
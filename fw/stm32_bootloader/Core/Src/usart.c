@@ -25,6 +25,7 @@
 #include <stdarg.h>
 #include "main.h"
 #include "fw_uart.h"
+#include "fw_trace.h"
 
 #define LOG_BUFFER_SIZE 256
 
@@ -179,6 +180,8 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 {
   if (huart->Instance == USART1)
   {
+    FW_TRACE(FW_TRACE_EVT_UART_ISR, uart_rx_byte);
+
     /* 将接收到的字节传递给UART传输层 */
     FW_UART_RxCallback(uart_rx_byte);
 
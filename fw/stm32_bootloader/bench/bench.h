@@ -0,0 +1,62 @@
+/**
+ ******************************************************************************
+ * @file    bench.h
+ * @brief   QEMU基准测试公共定义
+ * @note    外设桩函数与基准测试主程序之间的接口
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026
+ *
+ ******************************************************************************
+ */
+
+#ifndef __BENCH_H
+#define __BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "main.h"
+
+/* 导出定义 ---------------------------------------------------------------*/
+
+#define BENCH_FLASH_SIZE        (FLASH_APP_END_ADDR - FLASH_APP_START_ADDR)  /**< 模拟应用区大小 */
+
+/* 导出类型定义 -------------------------------------------------------------*/
+
+/**
+ * @brief 桩函数统计
+ */
+typedef struct {
+    uint32_t tx_count;                  /**< 发送的CAN帧数 */
+    uint32_t last_code;                 /**< 最近一次响应码 */
+    uint32_t last_value;                /**< 最近一次响应参数 */
+    uint32_t erased_pages;              /**< 擦除页数 */
+    uint32_t programmed_bytes;          /**< 编程字节数 */
+    uint8_t flash_error;                /**< 越界编程等错误 */
+} bench_stub_stats_t;
+
+/* 导出变量 ---------------------------------------------------------------*/
+
+extern uint8_t bench_flash[BENCH_FLASH_SIZE];     /**< 以RAM模拟的应用区 */
+extern bench_stub_stats_t bench_stub_stats;
+
+/* 导出函数 ---------------------------------------------------------------*/
+
+/**
+ * @brief 设置下一次HAL_CAN_GetRxMessage返回的帧
+ * @param id CAN ID
+ * @param data 数据指针
+ * @param len 数据长度
+ */
+void Bench_SetRxFrame(uint32_t id, const uint8_t *data, uint8_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BENCH_H */
@@ -0,0 +1,282 @@
+/**
+ ******************************************************************************
+ * @file    bench_main.c
+ * @brief   QEMU mps2-an385 bootloader热路径基准测试
+ * @note    以脚本化CAN帧流驱动真实的中断回调、环形缓冲区和升级核心，
+ *          统计每帧及每页的周期数，超出预算时以非零状态退出
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "bench.h"
+#include "fw_upgrade.h"
+#include "fw_can.h"
+#include "fw_transport.h"
+#include "stm32f1xx_it.h"
+#include <string.h>
+
+/* 私有定义 ---------------------------------------------------------------*/
+
+#ifndef BENCH_IMAGE_SIZE
+#define BENCH_IMAGE_SIZE            (64 * 1024)   /**< 脚本化固件大小 */
+#endif
+
+#ifndef BENCH_SYSTICK_HZ
+#define BENCH_SYSTICK_HZ            25000000      /**< mps2-an385 SysTick时钟 */
+#endif
+
+#ifndef BENCH_ICOUNT_SHIFT
+#define BENCH_ICOUNT_SHIFT          6             /**< 与QEMU -icount shift一致 */
+#endif
+
+/* 预算（周期），为0时只报告不判定 */
+#ifndef BENCH_BUDGET_ISR_CYCLES
+#define BENCH_BUDGET_ISR_CYCLES     0
+#endif
+#ifndef BENCH_BUDGET_RX_CYCLES
+#define BENCH_BUDGET_RX_CYCLES      0
+#endif
+#ifndef BENCH_BUDGET_PAGE_CYCLES
+#define BENCH_BUDGET_PAGE_CYCLES    0
+#endif
+
+/* CMSDK APB UART0 */
+#define BENCH_UART_BASE             0x40004000UL
+#define BENCH_UART_DATA             (*(volatile uint32_t *)(BENCH_UART_BASE + 0x00))
+#define BENCH_UART_STATE            (*(volatile uint32_t *)(BENCH_UART_BASE + 0x04))
+#define BENCH_UART_CTRL             (*(volatile uint32_t *)(BENCH_UART_BASE + 0x08))
+#define BENCH_UART_BAUDDIV          (*(volatile uint32_t *)(BENCH_UART_BASE + 0x10))
+
+/* 半主机退出原因 */
+#define SEMIHOST_SYS_EXIT           0x18
+#define ADP_STOPPED_APP_EXIT        0x20026
+#define ADP_STOPPED_RUNTIME_ERROR   0x20023
+
+#define SYSTICK_MAX                 0x00FFFFFFUL
+
+_Static_assert(BENCH_IMAGE_SIZE % 8 == 0, "BENCH_IMAGE_SIZE must be a multiple of 8");
+_Static_assert(BENCH_IMAGE_SIZE <= BENCH_FLASH_SIZE, "BENCH_IMAGE_SIZE exceeds app area");
+
+/* 私有变量 ---------------------------------------------------------------*/
+
+static const fw_transport_t bench_transport = {
+    .name = "CAN",
+    .init = FW_CAN_Init,
+    .process_rx_data = FW_CAN_ProcessRxData,
+    .send_response = FW_CAN_SendResponse,
+    .send_data = FW_CAN_SendData,
+    .wait_tx_complete = FW_CAN_WaitTxComplete
+};
+
+/* 私有函数 ---------------------------------------------------------------*/
+
+/**
+ * @brief 通过半主机退出QEMU
+ * @param ok 1-成功 0-失败
+ */
+static void Bench_Exit(uint8_t ok)
+{
+    register uint32_t r0 __asm__("r0") = SEMIHOST_SYS_EXIT;
+    register uint32_t r1 __asm__("r1") = ok ? ADP_STOPPED_APP_EXIT : ADP_STOPPED_RUNTIME_ERROR;
+
+    __asm__ volatile ("bkpt 0xAB" : : "r"(r0), "r"(r1) : "memory");
+    while (1)
+    {
+    }
+}
+
+static void Bench_UartInit(void)
+{
+    BENCH_UART_BAUDDIV = 16;
+    BENCH_UART_CTRL = 0x01;     /* TX使能 */
+}
+
+static void Bench_Puts(const char *s)
+{
+    while (*s)
+    {
+        while (BENCH_UART_STATE & 0x01)     /* TX满 */
+        {
+        }
+        BENCH_UART_DATA = (uint8_t)*s++;
+    }
+}
+
+static void Bench_PutDec(uint32_t value)
+{
+    char buf[11];
+    int i = sizeof(buf) - 1;
+
+    buf[i] = '\0';
+    do
+    {
+        buf[--i] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    Bench_Puts(&buf[i]);
+}
+
+static void Bench_Report(const char *name, uint32_t value, uint32_t budget, uint8_t *ok)
+{
+    Bench_Puts("[BENCH] ");
+    Bench_Puts(name);
+    Bench_Puts(" = ");
+    Bench_PutDec(value);
+    if (budget != 0)
+    {
+        Bench_Puts(" (budget ");
+        Bench_PutDec(budget);
+        Bench_Puts(value <= budget ? ", ok)" : ", EXCEEDED)");
+        if (value > budget)
+        {
+            *ok = 0;
+        }
+    }
+    Bench_Puts("\r\n");
+}
+
+/**
+ * @brief 读取SysTick当前值（递减计数）
+ */
+static inline uint32_t Bench_Now(void)
+{
+    return SysTick->VAL;
+}
+
+/**
+ * @brief 计算两次采样之间的SysTick节拍数
+ * @note 单次测量区间远小于24位计数器的回绕周期
+ */
+static inline uint32_t Bench_Elapsed(uint32_t start, uint32_t end)
+{
+    return (start - end) & SYSTICK_MAX;
+}
+
+/**
+ * @brief SysTick节拍换算为周期（QEMU -icount下每条指令计为一个周期）
+ */
+static uint32_t Bench_TicksToCycles(uint64_t ticks)
+{
+    return (uint32_t)((ticks * 1000000000ULL) / ((uint64_t)BENCH_SYSTICK_HZ << BENCH_ICOUNT_SHIFT));
+}
+
+static uint8_t Bench_ImageByte(uint32_t offset)
+{
+    return (uint8_t)((offset * 31U) ^ (offset >> 8) ^ 0x5A);
+}
+
+/**
+ * @brief 模拟一次CAN接收中断并执行一次主循环
+ * @param id CAN ID
+ * @param data 数据指针
+ * @param len 数据长度
+ * @param isr_ticks 累计中断节拍
+ * @param rx_ticks 累计主循环处理节拍
+ */
+static void Bench_Feed(uint32_t id, const uint8_t *data, uint8_t len,
+                       uint64_t *isr_ticks, uint64_t *rx_ticks)
+{
+    uint32_t t0, t1, t2;
+
+    Bench_SetRxFrame(id, data, len);
+
+    t0 = Bench_Now();
+    CAN1_RX1_IRQHandler();
+    t1 = Bench_Now();
+    FW_Transport_ProcessRxData();
+    t2 = Bench_Now();
+
+    *isr_ticks += Bench_Elapsed(t0, t1);
+    *rx_ticks += Bench_Elapsed(t1, t2);
+}
+
+/* 导出函数 ---------------------------------------------------------------*/
+
+void Error_Handler(void)
+{
+    Bench_Puts("[BENCH] Error_Handler\r\n");
+    Bench_Exit(0);
+}
+
+int main(void)
+{
+    uint64_t isr_ticks = 0, rx_ticks = 0;
+    uint64_t erase_isr_ticks = 0, erase_rx_ticks = 0;
+    uint32_t frames = BENCH_IMAGE_SIZE / 8;
+    uint32_t pages = BENCH_IMAGE_SIZE / FLASH_SECTOR_SIZE;
+    uint8_t data[8];
+    uint32_t word;
+    uint8_t ok = 1;
+
+    Bench_UartInit();
+
+    /* SysTick以处理器时钟自由运行，不开中断 */
+    SysTick->LOAD = SYSTICK_MAX;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+
+    Bench_Puts("[BENCH] stm32_bootloader hot path, image ");
+    Bench_PutDec(BENCH_IMAGE_SIZE);
+    Bench_Puts(FW_TRANSPORT_STATIC ? " bytes, static transport\r\n" : " bytes, dynamic transport\r\n");
+
+    FW_Upgrade_Init(&bench_transport);
+
+    /* START_UPDATE：包含按固件大小擦除 */
+    word = FW_CMD_START_UPDATE;
+    memcpy(&data[0], &word, 4);
+    word = BENCH_IMAGE_SIZE;
+    memcpy(&data[4], &word, 4);
+    Bench_Feed(CAN_ID_PLATFORM_RX, data, 8, &erase_isr_ticks, &erase_rx_ticks);
+
+    /* 固件数据帧流 */
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        for (uint32_t j = 0; j < 8; j++)
+        {
+            data[j] = Bench_ImageByte(i * 8 + j);
+        }
+        Bench_Feed(CAN_ID_FW_DATA_RX, data, 8, &isr_ticks, &rx_ticks);
+    }
+
+    /* 校验升级结果 */
+    if (bench_stub_stats.last_code != FW_CODE_UPDATE_SUCCESS ||
+        bench_stub_stats.last_value != BENCH_IMAGE_SIZE ||
+        bench_stub_stats.flash_error)
+    {
+        Bench_Puts("[BENCH] upgrade did not complete\r\n");
+        Bench_Exit(0);
+    }
+    for (uint32_t i = 0; i < BENCH_IMAGE_SIZE; i++)
+    {
+        if (bench_flash[i] != Bench_ImageByte(i))
+        {
+            Bench_Puts("[BENCH] flash content mismatch at ");
+            Bench_PutDec(i);
+            Bench_Puts("\r\n");
+            Bench_Exit(0);
+        }
+    }
+
+    Bench_Report("frames", frames, 0, &ok);
+    Bench_Report("responses", bench_stub_stats.tx_count, 0, &ok);
+    Bench_Report("isr_cycles_per_frame", Bench_TicksToCycles(isr_ticks) / frames,
+                 BENCH_BUDGET_ISR_CYCLES, &ok);
+    Bench_Report("rx_cycles_per_frame", Bench_TicksToCycles(rx_ticks) / frames,
+                 BENCH_BUDGET_RX_CYCLES, &ok);
+    Bench_Report("cycles_per_page", Bench_TicksToCycles(isr_ticks + rx_ticks) / pages,
+                 BENCH_BUDGET_PAGE_CYCLES, &ok);
+    Bench_Report("erase_cycles_per_page",
+                 Bench_TicksToCycles(erase_isr_ticks + erase_rx_ticks) / bench_stub_stats.erased_pages,
+                 0, &ok);
+
+    Bench_Puts(ok ? "[BENCH] PASS\r\n" : "[BENCH] FAIL\r\n");
+    Bench_Exit(ok);
+
+    return 0;
+}
@@ -0,0 +1,201 @@
+/**
+ ******************************************************************************
+ * @file    hal_stub.c
+ * @brief   QEMU基准测试外设桩函数
+ * @note    Flash以RAM数组模拟，CAN接收由脚本化帧流提供，发送只做记录；
+ *          仅测量软件路径开销，不模拟真实Flash擦写时间
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "bench.h"
+#include <string.h>
+
+/* 外设句柄（原定义位于can.c/usart.c/stm32f1xx_hal_timebase_tim.c） */
+CAN_HandleTypeDef hcan;
+UART_HandleTypeDef huart1;
+TIM_HandleTypeDef htim1;
+
+/* 导出变量 ---------------------------------------------------------------*/
+
+uint8_t bench_flash[BENCH_FLASH_SIZE];
+bench_stub_stats_t bench_stub_stats;
+
+/* 私有变量 ---------------------------------------------------------------*/
+
+static uint32_t rx_frame_id;
+static uint8_t rx_frame_data[8];
+static uint8_t rx_frame_len;
+
+/* 导出函数 ---------------------------------------------------------------*/
+
+/**
+ * @brief 设置下一次HAL_CAN_GetRxMessage返回的帧
+ * @param id CAN ID
+ * @param data 数据指针
+ * @param len 数据长度
+ */
+void Bench_SetRxFrame(uint32_t id, const uint8_t *data, uint8_t len)
+{
+    rx_frame_id = id;
+    rx_frame_len = len;
+    memcpy(rx_frame_data, data, len);
+}
+
+/* HAL通用 ----------------------------------------------------------------*/
+
+void HAL_Delay(uint32_t Delay)
+{
+    (void)Delay;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    /* 回读确认超时依赖节拍，基准测试不走回读路径 */
+    return 0;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    (void)GPIOx;
+    (void)GPIO_Pin;
+    (void)PinState;
+}
+
+/* Flash ------------------------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+    uint32_t size = (TypeProgram == FLASH_TYPEPROGRAM_DOUBLEWORD) ? 8 :
+                    (TypeProgram == FLASH_TYPEPROGRAM_WORD) ? 4 : 2;
+
+    if (Address < FLASH_APP_START_ADDR || Address + size > FLASH_APP_END_ADDR)
+    {
+        bench_stub_stats.flash_error = 1;
+        return HAL_ERROR;
+    }
+
+    memcpy(&bench_flash[Address - FLASH_APP_START_ADDR], &Data, size);
+    bench_stub_stats.programmed_bytes += size;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError)
+{
+    uint32_t offset = pEraseInit->PageAddress - FLASH_APP_START_ADDR;
+    uint32_t size = pEraseInit->NbPages * FLASH_SECTOR_SIZE;
+
+    *PageError = 0xFFFFFFFF;
+    if (pEraseInit->PageAddress < FLASH_APP_START_ADDR || offset + size > BENCH_FLASH_SIZE)
+    {
+        *PageError = pEraseInit->PageAddress;
+        bench_stub_stats.flash_error = 1;
+        return HAL_ERROR;
+    }
+
+    memset(&bench_flash[offset], 0xFF, size);
+    bench_stub_stats.erased_pages += pEraseInit->NbPages;
+    return HAL_OK;
+}
+
+/* CAN --------------------------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_CAN_ConfigFilter(CAN_HandleTypeDef *hcan, const CAN_FilterTypeDef *sFilterConfig)
+{
+    (void)hcan;
+    (void)sFilterConfig;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_Start(CAN_HandleTypeDef *hcan)
+{
+    (void)hcan;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_DeInit(CAN_HandleTypeDef *hcan)
+{
+    (void)hcan;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_ActivateNotification(CAN_HandleTypeDef *hcan, uint32_t ActiveITs)
+{
+    (void)hcan;
+    (void)ActiveITs;
+    return HAL_OK;
+}
+
+uint32_t HAL_CAN_GetTxMailboxesFreeLevel(const CAN_HandleTypeDef *hcan)
+{
+    (void)hcan;
+    return 3;
+}
+
+HAL_StatusTypeDef HAL_CAN_AddTxMessage(CAN_HandleTypeDef *hcan, const CAN_TxHeaderTypeDef *pHeader,
+                                       const uint8_t aData[], uint32_t *pTxMailbox)
+{
+    (void)hcan;
+    *pTxMailbox = CAN_TX_MAILBOX0;
+
+    if (pHeader->StdId == CAN_ID_PLATFORM_TX)
+    {
+        memcpy(&bench_stub_stats.last_code, &aData[0], 4);
+        memcpy(&bench_stub_stats.last_value, &aData[4], 4);
+    }
+    bench_stub_stats.tx_count++;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_GetRxMessage(CAN_HandleTypeDef *hcan, uint32_t RxFifo,
+                                       CAN_RxHeaderTypeDef *pHeader, uint8_t aData[])
+{
+    (void)hcan;
+    (void)RxFifo;
+
+    pHeader->StdId = rx_frame_id;
+    pHeader->ExtId = 0;
+    pHeader->IDE = CAN_ID_STD;
+    pHeader->RTR = CAN_RTR_DATA;
+    pHeader->DLC = rx_frame_len;
+    memcpy(aData, rx_frame_data, rx_frame_len);
+    return HAL_OK;
+}
+
+void HAL_CAN_IRQHandler(CAN_HandleTypeDef *hcan)
+{
+    HAL_CAN_RxFifo1MsgPendingCallback(hcan);
+}
+
+/* UART/TIM ---------------------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+    return HAL_OK;
+}
+
+void HAL_UART_IRQHandler(UART_HandleTypeDef *huart)
+{
+    (void)huart;
+}
+
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim)
+{
+    (void)htim;
+}
@@ -0,0 +1,75 @@
+/**
+ ******************************************************************************
+ * @file    startup.c
+ * @brief   QEMU mps2-an385 基准测试启动代码
+ * @note    向量表只保留Cortex-M3系统异常，异常处理函数沿用stm32f1xx_it.c
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2026
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+/* 外部声明 ---------------------------------------------------------------*/
+
+extern uint32_t _estack;
+extern uint32_t _sidata, _sdata, _edata, _sbss, _ebss;
+
+extern int main(void);
+
+void Reset_Handler(void);
+void NMI_Handler(void);
+void HardFault_Handler(void);
+void MemManage_Handler(void);
+void BusFault_Handler(void);
+void UsageFault_Handler(void);
+void SVC_Handler(void);
+void DebugMon_Handler(void);
+void PendSV_Handler(void);
+void SysTick_Handler(void);
+
+/* 向量表 -----------------------------------------------------------------*/
+
+typedef struct {
+    uint32_t *initial_sp;               /**< 初始栈指针 */
+    void (*handlers[15])(void);         /**< 系统异常处理函数 */
+} vector_table_t;
+
+__attribute__((section(".isr_vector"), used))
+static const vector_table_t vector_table = {
+    &_estack,
+    {
+        Reset_Handler,
+        NMI_Handler,
+        HardFault_Handler,
+        MemManage_Handler,
+        BusFault_Handler,
+        UsageFault_Handler,
+        0, 0, 0, 0,
+        SVC_Handler,
+        DebugMon_Handler,
+        0,
+        PendSV_Handler,
+        SysTick_Handler,
+    }
+};
+
+/**
+ * @brief 复位入口：初始化.data/.bss后进入基准测试
+ */
+void Reset_Handler(void)
+{
+    memcpy(&_sdata, &_sidata, (size_t)((uint8_t *)&_edata - (uint8_t *)&_sdata));
+    memset(&_sbss, 0, (size_t)((uint8_t *)&_ebss - (uint8_t *)&_sbss));
+
+    main();
+
+    while (1)
+    {
+    }
+}
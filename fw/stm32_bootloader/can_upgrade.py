@@ -4,6 +4,8 @@ import os
 import struct
 import sys
 import tqdm
+import zlib
+import fw_trace
 
 FW_CODE_OFFSET = 0
 FW_CODE_UPDATE_SUCCESS = 1
@@ -11,15 +13,27 @@ FW_CODE_VERSION = 2
 FW_CODE_CONFIRM = 3
 FW_CODE_FLASH_ERROR = 4
 FW_CODE_TRANFER_ERROR = 5
+FW_CODE_TRACE_INFO = 6
+FW_CODE_RX_OVERFLOW = 7
+FW_CODE_READ_INFO = 8
+FW_CODE_READ_CRC = 9
+FW_CODE_READ_DONE = 10
+FW_CODE_READ_OFFSET = 11
 
 PLATFORM_RX   = 0x101
 PLATFORM_TX   = 0x102
 FW_DATA_RX    = 0x103
+FW_DATA_TX    = 0x104
 
 BOARD_START_UPDATE = 0
 BOARD_CONFIRM = 1
 BOARD_VERSION = 2
 BOARD_REBOOT = 3
+BOARD_TRACE_DUMP = 4
+BOARD_RESUME = 5
+BOARD_READ_FLASH = 6
+BOARD_READ_ACK = 7
+BOARD_READ_RESUME = 8
 
 def can_recv(bus: can.BusABC, timeout=5):
     while True:
@@ -29,6 +43,28 @@ def can_recv(bus: can.BusABC, timeout=5):
         if rx_frame.arbitration_id == PLATFORM_TX:
             return struct.unpack('<2I', rx_frame.data)
 
+def can_recv_data(bus: can.BusABC, timeout=5):
+    while True:
+        rx_frame = bus.recv(timeout)
+        if not rx_frame:
+            raise BaseException("can receive data timeout")
+        if rx_frame.arbitration_id == FW_DATA_TX:
+            return bytes(rx_frame.data)
+
+def firmware_resume(bus, offset):
+    # bootloader接收缓冲区溢出，从其已接收位置重传
+    while True:
+        data = struct.pack('<2I', BOARD_RESUME, offset)
+        msg = can.Message(arbitration_id=PLATFORM_RX, data=data, is_extended_id=False)
+        bus.send(msg)
+        code, value = can_recv(bus)
+        if code == FW_CODE_OFFSET and value == offset:
+            return
+        if code == FW_CODE_RX_OVERFLOW:
+            offset = value
+            continue
+        raise BaseException(f"firmware resume error: code({code}), offset({offset}, {value})")
+
 def firmware_upgrade(bus, file_name, test=False):
     with open(file_name, 'rb') as f:
         total_size = os.path.getsize(file_name)
@@ -52,6 +88,12 @@ def firmware_upgrade(bus, file_name, test=False):
             code, offset = can_recv(bus)
             if code == FW_CODE_UPDATE_SUCCESS and offset == bar.n:
                 break
+            if code == FW_CODE_RX_OVERFLOW:
+                firmware_resume(bus, offset)
+                f.seek(offset)
+                bar.n = offset
+                bar.refresh()
+                continue
             if code != FW_CODE_OFFSET:
                 raise BaseException(f"firmware upload error: code({code}), offset({bar.n}, {offset})")
 
@@ -80,6 +122,89 @@ def board_reboot(bus):
     msg = can.Message(arbitration_id=PLATFORM_RX, data=data, is_extended_id=False)
     bus.send(msg)
 
+def firmware_dump(bus, file_name, length=0, verify=None):
+    # 以本地镜像大小作为默认回读长度
+    if verify and length == 0:
+        length = os.path.getsize(verify)
+    data = struct.pack('<2I', BOARD_READ_FLASH, length)
+    msg = can.Message(arbitration_id=PLATFORM_RX, data=data, is_extended_id=False)
+    bus.send(msg)
+    code, total_size = can_recv(bus)
+    if code != FW_CODE_READ_INFO:
+        raise BaseException(f"flash read error: code({code})")
+
+    image = bytearray()
+    block = bytearray()
+    resync = False      # 已请求重发，丢弃READ_OFFSET之前的数据
+    bar = tqdm.tqdm(total=total_size)
+    while True:
+        rx_frame = bus.recv(5)
+        if not rx_frame:
+            raise BaseException(f"flash read timeout at offset {len(image) + len(block)}")
+        if rx_frame.arbitration_id == FW_DATA_TX:
+            if not resync:
+                block.extend(rx_frame.data)
+                bar.update(len(rx_frame.data))
+            continue
+        if rx_frame.arbitration_id != PLATFORM_TX:
+            continue
+        code, value = struct.unpack('<2I', rx_frame.data)
+        if code == FW_CODE_READ_CRC:
+            if resync:
+                continue
+            if zlib.crc32(block) != value:
+                # 块校验失败，请求bootloader从已校验位置重发
+                resync = True
+                block.clear()
+                data = struct.pack('<2I', BOARD_READ_RESUME, len(image))
+                bus.send(can.Message(arbitration_id=PLATFORM_RX, data=data, is_extended_id=False))
+                continue
+            image.extend(block)
+            block.clear()
+            # 确认已接收的字节数，推进bootloader发送窗口
+            data = struct.pack('<2I', BOARD_READ_ACK, len(image))
+            bus.send(can.Message(arbitration_id=PLATFORM_RX, data=data, is_extended_id=False))
+        elif code == FW_CODE_READ_OFFSET:
+            # bootloader从该偏移重发（确认超时或响应READ_RESUME），丢弃之后未确认的数据
+            if value > len(image):
+                raise BaseException(f"flash read resend error: offset({len(image)}, {value})")
+            del image[value:]
+            block.clear()
+            resync = False
+            bar.n = value
+            bar.refresh()
+        elif code == FW_CODE_READ_DONE:
+            break
+        else:
+            raise BaseException(f"flash read error: code({code}), offset({len(image)}, {value})")
+    bar.close()
+
+    with open(file_name, 'wb') as f:
+        f.write(image)
+    print(f"{len(image)} bytes written to {file_name}")
+
+    if verify:
+        with open(verify, 'rb') as f:
+            local = f.read()
+        if image[:len(local)] == local:
+            print(f"Verify OK: flash matches {verify}")
+        else:
+            offset = next((i for i, (a, b) in enumerate(zip(image, local)) if a != b), min(len(image), len(local)))
+            raise BaseException(f"verify failed: flash differs from {verify} at offset {offset}")
+
+def trace_dump(bus, file_name, clear=False, cpu_hz=fw_trace.DEFAULT_CPU_HZ):
+    data = struct.pack('<2I', BOARD_TRACE_DUMP, 1 if clear else 0)
+    msg = can.Message(arbitration_id=PLATFORM_RX, data=data, is_extended_id=False)
+    bus.send(msg)
+    code, count = can_recv(bus)
+    if code != FW_CODE_TRACE_INFO:
+        raise BaseException(f"trace dump error: code({code})")
+    raw = bytearray()
+    for _ in range(count):
+        raw.extend(can_recv_data(bus))
+    fw_trace.save_trace(raw, file_name, cpu_hz)
+    print(f"{count} trace records written to {file_name}")
+
 if __name__ == "__main__":
     if sys.platform.startswith('win'):
         interface, channel = 'pcan', 'PCAN_USBBUS1'
@@ -94,11 +219,20 @@ if __name__ == "__main__":
     board_parser = subparser.add_parser('board', help='board opt')
     board_parser.add_argument('-r', '--reboot', action='store_true', help='reboot board')
     board_parser.add_argument('-v', '--version', action='store_true', help='get board version')
+    dump_parser = subparser.add_parser('dump', help='read back app image from flash')
+    dump_parser.add_argument('file', help='output image file name')
+    dump_parser.add_argument('-l', '--length', type=lambda x: int(x, 0), default=0, help='bytes to read (default: whole app area)')
+    dump_parser.add_argument('--verify', metavar='IMAGE', help='compare read back data against local image')
+    trace_parser = subparser.add_parser('trace', help='dump bootloader event trace')
+    trace_parser.add_argument('-o', '--output', default='trace.json', help='Chrome/Perfetto trace JSON file')
+    trace_parser.add_argument('--clear', action='store_true', help='clear trace buffer after dump')
+    trace_parser.add_argument('--cpu-hz', type=int, default=fw_trace.DEFAULT_CPU_HZ, help='core clock in Hz')
     args = parser.parse_args()
     bus = can.interface.Bus(interface=interface, channel=args.channel, bitrate=250000)
 
     filters = [
         {"can_id": PLATFORM_TX, "can_mask": 0x10f, "extended": False},
+        {"can_id": FW_DATA_TX, "can_mask": 0x10f, "extended": False},
     ]
     bus.set_filters(filters)
 
@@ -109,5 +243,9 @@ if __name__ == "__main__":
             board_reboot(bus)
         elif args.version:
             firmware_version(bus)
+    elif args.command == 'dump':
+        firmware_dump(bus, args.file, length=args.length, verify=args.verify)
+    elif args.command == 'trace':
+        trace_dump(bus, args.output, clear=args.clear, cpu_hz=args.cpu_hz)
 
     bus.shutdown()
@@ -0,0 +1,93 @@
+import argparse
+import json
+import struct
+
+# 追踪事件类型，与Core/Inc/fw_trace.h中fw_trace_evt_t保持一致
+TRACE_EVT_CAN_ISR = 1
+TRACE_EVT_UART_ISR = 2
+TRACE_EVT_RING_PUSH = 3
+TRACE_EVT_RING_POP = 4
+TRACE_EVT_ERASE_START = 5
+TRACE_EVT_ERASE_END = 6
+TRACE_EVT_PROGRAM_START = 7
+TRACE_EVT_PROGRAM_END = 8
+TRACE_EVT_ACK_SENT = 9
+
+TRACE_RECORD_SIZE = 8
+DEFAULT_CPU_HZ = 72000000
+
+# 事件名称及所在线程（tid 1: 中断上下文，tid 2: 主循环）
+INSTANT_EVENTS = {
+    TRACE_EVT_CAN_ISR: ("can_isr", 1),
+    TRACE_EVT_UART_ISR: ("uart_isr", 1),
+    TRACE_EVT_RING_PUSH: ("ring_push", 1),
+    TRACE_EVT_RING_POP: ("ring_pop", 2),
+    TRACE_EVT_ACK_SENT: ("ack_sent", 2),
+}
+
+# 成对事件: 开始事件 -> (名称, 结束事件)
+DURATION_EVENTS = {
+    TRACE_EVT_ERASE_START: ("flash_erase", TRACE_EVT_ERASE_END),
+    TRACE_EVT_PROGRAM_START: ("flash_program", TRACE_EVT_PROGRAM_END),
+}
+DURATION_END_EVENTS = {end: name for name, end in DURATION_EVENTS.values()}
+
+
+def parse_records(raw):
+    """解析导出的原始记录，返回[(cycle, event, arg), ...]"""
+    records = []
+    for i in range(0, len(raw) - len(raw) % TRACE_RECORD_SIZE, TRACE_RECORD_SIZE):
+        cycle, info = struct.unpack_from('<2I', raw, i)
+        records.append((cycle, info >> 24, info & 0xFFFFFF))
+    return records
+
+
+def to_chrome_trace(records, cpu_hz=DEFAULT_CPU_HZ):
+    """转换为Chrome/Perfetto trace JSON对象"""
+    events = [
+        {"name": "thread_name", "ph": "M", "pid": 1, "tid": 1, "args": {"name": "irq"}},
+        {"name": "thread_name", "ph": "M", "pid": 1, "tid": 2, "args": {"name": "main"}},
+    ]
+    if not records:
+        return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+    # DWT->CYCCNT为32位计数器，72MHz下约60秒回绕一次，按单调递增展开
+    base = records[0][0]
+    wraps = 0
+    prev = base
+    for cycle, evt, arg in records:
+        if cycle < prev:
+            wraps += 1
+        prev = cycle
+        ts = ((cycle + (wraps << 32)) - base) * 1e6 / cpu_hz
+        if evt in DURATION_EVENTS:
+            name = DURATION_EVENTS[evt][0]
+            events.append({"name": name, "ph": "B", "pid": 1, "tid": 2, "ts": ts, "args": {"arg": arg}})
+        elif evt in DURATION_END_EVENTS:
+            name = DURATION_END_EVENTS[evt]
+            events.append({"name": name, "ph": "E", "pid": 1, "tid": 2, "ts": ts, "args": {"status": arg}})
+        else:
+            name, tid = INSTANT_EVENTS.get(evt, (f"event_{evt}", 2))
+            events.append({"name": name, "ph": "i", "s": "t", "pid": 1, "tid": tid, "ts": ts, "args": {"arg": arg}})
+
+    return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+def save_trace(raw, file_name, cpu_hz=DEFAULT_CPU_HZ):
+    """将原始记录转换后写入JSON文件，返回记录条数"""
+    records = parse_records(raw)
+    with open(file_name, 'w') as f:
+        json.dump(to_chrome_trace(records, cpu_hz), f)
+    return len(records)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Convert bootloader trace dump to Chrome/Perfetto JSON")
+    parser.add_argument('file', help='raw trace dump file (8 bytes per record)')
+    parser.add_argument('-o', '--output', default='trace.json', help='output JSON file (default: trace.json)')
+    parser.add_argument('--cpu-hz', type=int, default=DEFAULT_CPU_HZ, help='core clock in Hz (default: 72000000)')
+    args = parser.parse_args()
+
+    with open(args.file, 'rb') as f:
+        count = save_trace(f.read(), args.output, args.cpu_hz)
+    print(f"{count} records written to {args.output}")
@@ -6,6 +6,8 @@ import tqdm
 import serial
 import serial.tools.list_ports
 import time
+import zlib
+import fw_trace
 
 # 响应码定义
 FW_CODE_OFFSET = 0
@@ -14,12 +16,23 @@ FW_CODE_VERSION = 2
 FW_CODE_CONFIRM = 3
 FW_CODE_FLASH_ERROR = 4
 FW_CODE_TRANFER_ERROR = 5
+FW_CODE_TRACE_INFO = 6
+FW_CODE_RX_OVERFLOW = 7
+FW_CODE_READ_INFO = 8
+FW_CODE_READ_CRC = 9
+FW_CODE_READ_DONE = 10
+FW_CODE_READ_OFFSET = 11
 
 # 命令码定义
 BOARD_START_UPDATE = 0
 BOARD_CONFIRM = 1
 BOARD_VERSION = 2
 BOARD_REBOOT = 3
+BOARD_TRACE_DUMP = 4
+BOARD_RESUME = 5
+BOARD_READ_FLASH = 6
+BOARD_READ_ACK = 7
+BOARD_READ_RESUME = 8
 
 # UART协议帧格式定义
 FRAME_HEAD = 0xAA
@@ -106,36 +119,59 @@ def parse_frame(buffer):
     return frame_type, data, total_len
 
 
-def uart_recv(ser: serial.Serial, timeout=5):
-    """接收UART响应"""
-    buffer = bytearray()
+# 接收缓冲区，跨调用保留未解析的字节（连续数据帧可能一次读入多帧）
+rx_buffer = bytearray()
+
+
+def uart_recv_frame(ser: serial.Serial, timeout=5):
+    """接收一个完整的UART帧，返回(frame_type, data)"""
+    global rx_buffer
     start_time = time.time()
 
     while True:
+        # 先解析缓冲区中已有的数据
+        frame_type, frame_data, consumed = parse_frame(rx_buffer)
+        if consumed > 0:
+            rx_buffer = rx_buffer[consumed:]
+        if frame_type is not None:
+            return frame_type, frame_data
+        if consumed > 0:
+            continue
+
         if time.time() - start_time > timeout:
             raise BaseException("UART receive timeout")
 
         # 读取可用数据
         if ser.in_waiting > 0:
-            data = ser.read(ser.in_waiting)
-            buffer.extend(data)
-
-            # 尝试解析帧
-            frame_type, frame_data, consumed = parse_frame(buffer)
-
-            if frame_type is not None:
-                # 成功解析帧
-                buffer = buffer[consumed:]
-                # 解析数据: 2个uint32_t
-                if len(frame_data) == 8:
-                    code, value = struct.unpack('<2I', frame_data)
-                    return code, value
-            else:
-                # 移除已消费的数据
-                if consumed > 0:
-                    buffer = buffer[consumed:]
+            rx_buffer.extend(ser.read(ser.in_waiting))
+        else:
+            time.sleep(0.001)
+
+
+def uart_recv(ser: serial.Serial, timeout=5):
+    """接收UART响应"""
+    while True:
+        frame_type, frame_data = uart_recv_frame(ser, timeout)
+        # 解析数据: 2个uint32_t
+        if frame_type == FRAME_CMD and len(frame_data) == 8:
+            code, value = struct.unpack('<2I', frame_data)
+            return code, value
+
+
+def firmware_resume(ser, offset):
+    """bootloader接收缓冲区溢出，从其已接收位置重传"""
+    while True:
+        cmd_data = struct.pack('<2I', BOARD_RESUME, offset)
+        frame = build_frame(FRAME_CMD, cmd_data)
+        ser.write(frame)
 
-        time.sleep(0.001)
+        code, value = uart_recv(ser)
+        if code == FW_CODE_OFFSET and value == offset:
+            return
+        if code == FW_CODE_RX_OVERFLOW:
+            offset = value
+            continue
+        raise BaseException(f"Firmware resume error: code({code}), offset({offset}, {value})")
 
 
 def firmware_upgrade(ser, file_name, test=False):
@@ -172,6 +208,13 @@ def firmware_upgrade(ser, file_name, test=False):
             code, offset = uart_recv(ser)
             if code == FW_CODE_UPDATE_SUCCESS and offset == bar.n:
                 break
+            if code == FW_CODE_RX_OVERFLOW:
+                # 接收缓冲区溢出，按bootloader给出的偏移重传
+                firmware_resume(ser, offset)
+                f.seek(offset)
+                bar.n = offset
+                bar.refresh()
+                continue
             if code != FW_CODE_OFFSET:
                 raise BaseException(f"Firmware upload error: code({code}), offset({bar.n}, {offset})")
 
@@ -208,6 +251,97 @@ def board_reboot(ser):
     ser.write(frame)
 
 
+def firmware_dump(ser, file_name, length=0, verify=None):
+    """回读应用区固件并写入文件，可与本地镜像比对"""
+    # 以本地镜像大小作为默认回读长度
+    if verify and length == 0:
+        length = os.path.getsize(verify)
+
+    cmd_data = struct.pack('<2I', BOARD_READ_FLASH, length)
+    frame = build_frame(FRAME_CMD, cmd_data)
+    ser.write(frame)
+
+    code, total_size = uart_recv(ser)
+    if code != FW_CODE_READ_INFO:
+        raise BaseException(f"Flash read error: code({code})")
+
+    image = bytearray()
+    block = bytearray()
+    resync = False      # 已请求重发，丢弃READ_OFFSET之前的数据
+    bar = tqdm.tqdm(total=total_size, unit='B', unit_scale=True)
+    while True:
+        frame_type, frame_data = uart_recv_frame(ser)
+        if frame_type == FRAME_DATA:
+            if not resync:
+                block.extend(frame_data)
+                bar.update(len(frame_data))
+            continue
+        if frame_type != FRAME_CMD or len(frame_data) != 8:
+            continue
+
+        code, value = struct.unpack('<2I', frame_data)
+        if code == FW_CODE_READ_CRC:
+            if resync:
+                continue
+            if zlib.crc32(block) != value:
+                # 块校验失败，请求bootloader从已校验位置重发
+                resync = True
+                block.clear()
+                ser.write(build_frame(FRAME_CMD, struct.pack('<2I', BOARD_READ_RESUME, len(image))))
+                continue
+            image.extend(block)
+            block.clear()
+            # 确认已接收的字节数，推进bootloader发送窗口
+            ser.write(build_frame(FRAME_CMD, struct.pack('<2I', BOARD_READ_ACK, len(image))))
+        elif code == FW_CODE_READ_OFFSET:
+            # bootloader从该偏移重发（确认超时或响应READ_RESUME），丢弃之后未确认的数据
+            if value > len(image):
+                raise BaseException(f"Flash read resend error: offset({len(image)}, {value})")
+            del image[value:]
+            block.clear()
+            resync = False
+            bar.n = value
+            bar.refresh()
+        elif code == FW_CODE_READ_DONE:
+            break
+        else:
+            raise BaseException(f"Flash read error: code({code}), offset({len(image)}, {value})")
+    bar.close()
+
+    with open(file_name, 'wb') as f:
+        f.write(image)
+    print(f"{len(image)} bytes written to {file_name}")
+
+    if verify:
+        with open(verify, 'rb') as f:
+            local = f.read()
+        if image[:len(local)] == local:
+            print(f"Verify OK: flash matches {verify}")
+        else:
+            offset = next((i for i, (a, b) in enumerate(zip(image, local)) if a != b), min(len(image), len(local)))
+            raise BaseException(f"Verify failed: flash differs from {verify} at offset {offset}")
+
+
+def trace_dump(ser, file_name, clear=False, cpu_hz=fw_trace.DEFAULT_CPU_HZ):
+    """导出事件追踪记录并转换为Chrome/Perfetto JSON"""
+    cmd_data = struct.pack('<2I', BOARD_TRACE_DUMP, 1 if clear else 0)
+    frame = build_frame(FRAME_CMD, cmd_data)
+    ser.write(frame)
+
+    code, count = uart_recv(ser)
+    if code != FW_CODE_TRACE_INFO:
+        raise BaseException(f"Trace dump error: code({code})")
+
+    raw = bytearray()
+    while len(raw) < count * fw_trace.TRACE_RECORD_SIZE:
+        frame_type, frame_data = uart_recv_frame(ser)
+        if frame_type == FRAME_DATA:
+            raw.extend(frame_data)
+
+    fw_trace.save_trace(raw, file_name, cpu_hz)
+    print(f"{count} trace records written to {file_name}")
+
+
 def list_serial_ports():
     """列出可用的串口"""
     ports = serial.tools.list_ports.comports()
@@ -237,6 +371,16 @@ if __name__ == "__main__":
     board_parser.add_argument('-r', '--reboot', action='store_true', help='Reboot board')
     board_parser.add_argument('-v', '--version', action='store_true', help='Get board version')
 
+    dump_parser = subparser.add_parser('dump', help='Read back app image from flash')
+    dump_parser.add_argument('file', help='Output image file path')
+    dump_parser.add_argument('-l', '--length', type=lambda x: int(x, 0), default=0, help='Bytes to read (default: whole app area)')
+    dump_parser.add_argument('--verify', metavar='IMAGE', help='Compare read back data against local image')
+
+    trace_parser = subparser.add_parser('trace', help='Dump bootloader event trace')
+    trace_parser.add_argument('-o', '--output', default='trace.json', help='Chrome/Perfetto trace JSON file')
+    trace_parser.add_argument('--clear', action='store_true', help='Clear trace buffer after dump')
+    trace_parser.add_argument('--cpu-hz', type=int, default=fw_trace.DEFAULT_CPU_HZ, help='Core clock in Hz')
+
     args = parser.parse_args()
 
     # 列出可用串口
@@ -274,6 +418,10 @@ if __name__ == "__main__":
                 board_reboot(ser)
             elif args.version:
                 firmware_version(ser)
+        elif args.command == 'dump':
+            firmware_dump(ser, args.file, length=args.length, verify=args.verify)
+        elif args.command == 'trace':
+            trace_dump(ser, args.output, clear=args.clear, cpu_hz=args.cpu_hz)
         else:
             parser.print_help()
 
@@ -1,14 +1,19 @@
+#define _GNU_SOURCE
 #include "can_socket.h"
+#include <errno.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <dirent.h>
 #include <arpa/inet.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
-#include <sys/select.h>
+#include <sys/stat.h>
 #include <linux/can.h>
 #include <linux/can/raw.h>
 #include <net/if.h>
@@ -151,42 +156,23 @@ int can_socket_send(can_socket_t *sock, uint32_t id, const uint8_t *data, uint8_
         memcpy(frame.data, data, dlc);
     }
 
-    ssize_t nbytes = write(sock->fd, &frame, sizeof(struct can_frame));
-    return (nbytes == sizeof(struct can_frame)) ? 0 : -1;
-}
-
-int can_socket_recv(can_socket_t *sock, can_frame_t *frame, int timeout_ms)
-{
-    fd_set readfds;
-    struct timeval tv;
-    struct can_frame raw_frame;
-    ssize_t nbytes;
-
-    FD_ZERO(&readfds);
-    FD_SET(sock->fd, &readfds);
-
-    tv.tv_sec = timeout_ms / 1000;
-    tv.tv_usec = (timeout_ms % 1000) * 1000;
-
-    int ret = select(sock->fd + 1, &readfds, NULL, NULL, &tv);
-    if (ret <= 0) {
-        return -1;  /* 超时或错误 */
-    }
-
-    nbytes = read(sock->fd, &raw_frame, sizeof(struct can_frame));
-    if (nbytes < 0) {
-        return -1;
-    }
-
-    if (raw_frame.can_id != PLATFORM_TX) {
-        return -2;  /* 不匹配的 ID */
+    /* 发送队列满时退避重试而不是丢帧：EAGAIN 等到可写，ENOBUFS 时 socket 仍报告
+     * 可写，只能按 1、2、4... ms 定时重试，累计超过 CAN_SEND_RETRY_MS 放弃 */
+    int waited = 0, delay = 1;
+    while (1) {
+        ssize_t nbytes = write(sock->fd, &frame, sizeof(struct can_frame));
+        if (nbytes == sizeof(struct can_frame)) return 0;
+        if (nbytes >= 0) return -1;
+        int err = errno;
+        if (err == EINTR) continue;
+        if ((err != EAGAIN && err != EWOULDBLOCK && err != ENOBUFS) || waited >= CAN_SEND_RETRY_MS) {
+            return -1;
+        }
+        struct pollfd pfd = { .fd = sock->fd, .events = POLLOUT };
+        poll(err == ENOBUFS ? NULL : &pfd, err == ENOBUFS ? 0 : 1, delay);
+        waited += delay;
+        if (delay < 16) delay *= 2;
     }
-
-    frame->id = raw_frame.can_id;
-    frame->dlc = raw_frame.can_dlc;
-    memcpy(frame->data, raw_frame.data, 8);
-
-    return 0;
 }
 
 /* 打包两个 32 位整数到 CAN 数据 */
@@ -209,19 +195,148 @@ static void unpack_u32_array(const uint8_t *buf, uint32_t *v1, uint32_t *v2)
     *v2 = buf[4] | (buf[5] << 8) | (buf[6] << 16) | (buf[7] << 24);
 }
 
-static int can_recv_expect(can_socket_t *sock, uint32_t *code, uint32_t *offset, int timeout_ms)
+int can_socket_recv_batch(can_socket_t *sock, can_frame_t *frames, int max_frames)
 {
-    can_frame_t frame;
-    int ret;
+    struct can_frame raw[CAN_RX_BATCH];
+    struct iovec iov[CAN_RX_BATCH];
+    struct mmsghdr msgs[CAN_RX_BATCH];
+    int n;
 
-    while (1) {
-        ret = can_socket_recv(sock, &frame, timeout_ms);
-        if (ret < 0) {
-            return ret;
+    if (max_frames > CAN_RX_BATCH) {
+        max_frames = CAN_RX_BATCH;
+    }
+
+    memset(msgs, 0, sizeof(msgs[0]) * max_frames);
+    for (int i = 0; i < max_frames; i++) {
+        iov[i].iov_base = &raw[i];
+        iov[i].iov_len = sizeof(struct can_frame);
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    do {
+        n = recvmmsg(sock->fd, msgs, max_frames, MSG_DONTWAIT, NULL);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        if (msgs[i].msg_len != sizeof(struct can_frame)) {
+            continue;
         }
-        unpack_u32_array(frame.data, code, offset);
+        frames[count].id = raw[i].can_id;
+        frames[count].dlc = raw[i].can_dlc;
+        memcpy(frames[count].data, raw[i].data, 8);
+        count++;
+    }
+    return count;
+}
+
+void can_pending_init(can_pending_t *slot, uint32_t code_mask)
+{
+    memset(slot, 0, sizeof(*slot));
+    slot->id = PLATFORM_TX;
+    slot->code_mask = code_mask;
+    slot->max_offset = UINT32_MAX;
+}
+
+static int can_pending_match(can_pending_t *slot, const can_frame_t *frame)
+{
+    uint32_t code, value;
+
+    if (slot->done || frame->id != slot->id || frame->dlc < 8) {
         return 0;
     }
+    unpack_u32_array(frame->data, &code, &value);
+    if (code >= 32 || !(slot->code_mask & CAN_CODE_BIT(code))) {
+        return 0;
+    }
+    if ((code == FW_CODE_OFFSET || code == FW_CODE_UPDATE_SUCCESS) &&
+        (value < slot->min_offset || value > slot->max_offset)) {
+        return 0;
+    }
+
+    slot->code = code;
+    slot->value = value;
+    slot->done = 1;
+    return 1;
+}
+
+static int can_pending_any_done(const can_pending_t *slots, int nslots)
+{
+    for (int i = 0; i < nslots; i++) {
+        if (slots[i].done) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int64_t monotonic_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int can_socket_wait(can_socket_t *sock, can_pending_t *slots, int nslots, int timeout_ms)
+{
+    can_frame_t frames[CAN_RX_BATCH];
+    int64_t deadline = monotonic_ms() + timeout_ms;
+
+    while (!can_pending_any_done(slots, nslots)) {
+        int64_t remaining = deadline - monotonic_ms();
+        if (remaining < 0) {
+            return -1;
+        }
+
+        struct pollfd pfd = { .fd = sock->fd, .events = POLLIN };
+        int ret = poll(&pfd, 1, (int)remaining);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            return -1;  /* 超时或错误 */
+        }
+
+        /* 取空接收队列：未取满说明已无待收帧 */
+        int n;
+        do {
+            n = can_socket_recv_batch(sock, frames, CAN_RX_BATCH);
+            if (n < 0) {
+                return -1;
+            }
+            for (int i = 0; i < n; i++) {
+                int claimed = 0;
+                for (int j = 0; j < nslots && !claimed; j++) {
+                    claimed = can_pending_match(&slots[j], &frames[i]);
+                }
+                if (!claimed) {
+                    sock->discarded++;
+                }
+            }
+        } while (n == CAN_RX_BATCH);
+    }
+    return 0;
+}
+
+/* 等待单个响应：只认领 code_mask 中的响应码，OFFSET/UPDATE_SUCCESS 须落在 [min_offset, max_offset] */
+static int can_recv_expect(can_socket_t *sock, uint32_t code_mask, uint32_t min_offset, uint32_t max_offset,
+                           uint32_t *code, uint32_t *offset, int timeout_ms)
+{
+    can_pending_t slot;
+
+    can_pending_init(&slot, code_mask);
+    slot.min_offset = min_offset;
+    slot.max_offset = max_offset;
+    if (can_socket_wait(sock, &slot, 1, timeout_ms) < 0) {
+        return -1;
+    }
+    *code = slot.code;
+    *offset = slot.value;
+    return 0;
 }
 
 int can_firmware_upgrade(can_socket_t *sock, const char *file_path, int test,
@@ -229,15 +344,21 @@ int can_firmware_upgrade(can_socket_t *sock, const char *file_path, int test,
                          void (*log_cb)(const char*, void*),
                          void *user_data)
 {
-    FILE *fp;
-    long file_size;
+    int fd;
+    struct stat st;
+    const uint8_t *image;
+    size_t file_size;
     uint8_t data[8];
     uint32_t code, offset;
     size_t sent = 0;
     char log_buf[256];
 
-    fp = fopen(file_path, "rb");
-    if (!fp) {
+    /* 只读映射整个镜像，发送时直接从映射取数据，不再逐帧 fread */
+    fd = open(file_path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0 || fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
         if (log_cb) {
             snprintf(log_buf, sizeof(log_buf), "无法打开文件: %s", file_path);
             log_cb(log_buf, user_data);
@@ -245,22 +366,36 @@ int can_firmware_upgrade(can_socket_t *sock, const char *file_path, int test,
         return -1;
     }
 
-    fseek(fp, 0, SEEK_END);
-    file_size = ftell(fp);
-    fseek(fp, 0, SEEK_SET);
+    file_size = (size_t)st.st_size;
+    image = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        if (log_cb) {
+            snprintf(log_buf, sizeof(log_buf), "映射文件失败: %s", file_path);
+            log_cb(log_buf, user_data);
+        }
+        return -1;
+    }
+    madvise((void *)image, file_size, MADV_SEQUENTIAL);
 
     /* 发送开始升级命令 */
     pack_u32_array(data, BOARD_START_UPDATE, file_size);
-    can_socket_send(sock, PLATFORM_RX, data, 8);
+    if (can_socket_send(sock, PLATFORM_RX, data, 8) < 0) {
+        munmap((void *)image, file_size);
+        if (log_cb) log_cb("发送命令失败", user_data);
+        return -1;
+    }
 
-    if (can_recv_expect(sock, &code, &offset, 5000) < 0) {
-        fclose(fp);
+    /* 擦除完成回 OFFSET(0)，上次中断的传输残留的 OFFSET(n) 被丢弃 */
+    if (can_recv_expect(sock, CAN_CODE_BIT(FW_CODE_OFFSET) | CAN_CODE_BIT(FW_CODE_FLASH_ERROR) |
+                        CAN_CODE_BIT(FW_CODE_TRANFER_ERROR), 0, 0, &code, &offset, 5000) < 0) {
+        munmap((void *)image, file_size);
         if (log_cb) log_cb("接收超时", user_data);
         return -1;
     }
 
-    if (code != FW_CODE_OFFSET || offset != 0) {
-        fclose(fp);
+    if (code != FW_CODE_OFFSET) {
+        munmap((void *)image, file_size);
         if (log_cb) {
             snprintf(log_buf, sizeof(log_buf), "Flash 擦除错误: code=%u, offset=%u", code, offset);
             log_cb(log_buf, user_data);
@@ -269,13 +404,14 @@ int can_firmware_upgrade(can_socket_t *sock, const char *file_path, int test,
     }
 
     /* 发送固件数据 */
-    while (1) {
-        size_t nread = fread(data, 1, 8, fp);
-        if (nread == 0) {
-            break;
-        }
+    while (sent < file_size) {
+        size_t nread = (file_size - sent < 8) ? file_size - sent : 8;
 
-        can_socket_send(sock, FW_DATA_RX, data, nread);
+        if (can_socket_send(sock, FW_DATA_RX, image + sent, nread) < 0) {
+            munmap((void *)image, file_size);
+            if (log_cb) log_cb("发送固件数据失败", user_data);
+            return -1;
+        }
         sent += nread;
 
         if (progress_cb) {
@@ -283,21 +419,24 @@ int can_firmware_upgrade(can_socket_t *sock, const char *file_path, int test,
         }
 
         /* 每 64 字节或结束时等待确认 */
-        if (sent % 64 != 0 && sent < (size_t)file_size) {
+        if (sent % 64 != 0 && sent < file_size) {
             continue;
         }
 
-        if (can_recv_expect(sock, &code, &offset, 5000) < 0) {
-            fclose(fp);
+        /* 只接受本块的 ACK，偏移不符的过期 ACK 被丢弃 */
+        if (can_recv_expect(sock, CAN_CODE_BIT(FW_CODE_OFFSET) | CAN_CODE_BIT(FW_CODE_UPDATE_SUCCESS) |
+                            CAN_CODE_BIT(FW_CODE_FLASH_ERROR) | CAN_CODE_BIT(FW_CODE_TRANFER_ERROR),
+                            (uint32_t)sent, (uint32_t)sent, &code, &offset, 5000) < 0) {
+            munmap((void *)image, file_size);
             if (log_cb) log_cb("接收超时", user_data);
             return -1;
         }
 
-        if (code == FW_CODE_UPDATE_SUCCESS && offset == sent) {
+        if (code == FW_CODE_UPDATE_SUCCESS) {
             break;
         }
         if (code != FW_CODE_OFFSET) {
-            fclose(fp);
+            munmap((void *)image, file_size);
             if (log_cb) {
                 snprintf(log_buf, sizeof(log_buf), "固件上传错误: code=%u, offset=%u", code, offset);
                 log_cb(log_buf, user_data);
@@ -306,13 +445,17 @@ int can_firmware_upgrade(can_socket_t *sock, const char *file_path, int test,
         }
     }
 
-    fclose(fp);
+    munmap((void *)image, file_size);
 
     /* 发送确认命令 */
     pack_u32_array(data, BOARD_CONFIRM, test ? 0 : 1);
-    can_socket_send(sock, PLATFORM_RX, data, 8);
+    if (can_socket_send(sock, PLATFORM_RX, data, 8) < 0) {
+        if (log_cb) log_cb("发送命令失败", user_data);
+        return -1;
+    }
 
-    if (can_recv_expect(sock, &code, &offset, 30000) < 0) {
+    if (can_recv_expect(sock, CAN_CODE_BIT(FW_CODE_CONFIRM) | CAN_CODE_BIT(FW_CODE_TRANFER_ERROR),
+                        0, UINT32_MAX, &code, &offset, 30000) < 0) {
         if (log_cb) log_cb("确认超时", user_data);
         return -1;
     }
@@ -338,7 +481,7 @@ int can_firmware_get_version(can_socket_t *sock, char *version_str, size_t len)
     pack_u32_array(data, BOARD_VERSION, 0);
     can_socket_send(sock, PLATFORM_RX, data, 8);
 
-    if (can_recv_expect(sock, &code, &version, 5000) < 0) {
+    if (can_recv_expect(sock, CAN_CODE_BIT(FW_CODE_VERSION), 0, UINT32_MAX, &code, &version, 5000) < 0) {
         return -1;
     }
 
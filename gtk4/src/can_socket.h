@@ -23,10 +23,15 @@
 #define BOARD_VERSION       2
 #define BOARD_REBOOT        3
 
+#define CAN_RX_BATCH  32   /* 单次 recvmmsg 的最大帧数 */
+#define CAN_SEND_RETRY_MS  200  /* 发送队列满 (EAGAIN/ENOBUFS) 时的最长重试时间 */
+#define CAN_CODE_BIT(code)  (1u << (code))
+
 /* CAN Socket 结构 */
 typedef struct {
     int fd;
     char interface[32];
+    size_t discarded;       /* 无请求认领而丢弃的帧数（过期 ACK、其他 ID） */
 } can_socket_t;
 
 /* CAN 消息结构 */
@@ -36,6 +41,18 @@ typedef struct {
     uint8_t dlc;
 } can_frame_t;
 
+/* 等待中的请求：按 CAN ID 与响应码匹配，偏移不在 [min_offset, max_offset]
+ * 内的 OFFSET/UPDATE_SUCCESS 视为过期 ACK 丢弃，错误码不检查偏移 */
+typedef struct {
+    uint32_t id;
+    uint32_t code_mask;     /* 接受的响应码位图，见 CAN_CODE_BIT() */
+    uint32_t min_offset;
+    uint32_t max_offset;
+    int done;
+    uint32_t code;
+    uint32_t value;
+} can_pending_t;
+
 /* 函数声明 */
 char** can_enumerate_devices(int *count);
 void can_free_device_list(char **devices, int count);
@@ -43,7 +60,15 @@ can_socket_t* can_socket_create(const char *interface);
 void can_socket_destroy(can_socket_t *sock);
 
 int can_socket_send(can_socket_t *sock, uint32_t id, const uint8_t *data, uint8_t dlc);
-int can_socket_recv(can_socket_t *sock, can_frame_t *frame, int timeout_ms);
+/* 非阻塞取出最多 max_frames 个待收帧，返回帧数，出错返回 -1 */
+int can_socket_recv_batch(can_socket_t *sock, can_frame_t *frames, int max_frames);
+
+/* 初始化请求槽：ID 为 PLATFORM_TX，偏移不限 */
+void can_pending_init(can_pending_t *slot, uint32_t code_mask);
+
+/* 等待 slots 中任一请求完成，每次唤醒收取全部待收帧并按顺序分发；
+ * 返回 0 完成，-1 超时或出错 */
+int can_socket_wait(can_socket_t *sock, can_pending_t *slots, int nslots, int timeout_ms);
 
 /* 固件升级相关 */
 int can_firmware_upgrade(can_socket_t *sock, const char *file_path, int test,
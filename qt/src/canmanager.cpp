@@ -202,6 +202,12 @@ bool CanManager::firmwareUpgrade(const QString &fileName, bool testMode)
     }
 
     qint64 totalSize = file.size();
+    // Map the whole image once instead of issuing a read() per 8-byte frame
+    const uchar *image = totalSize > 0 ? file.map(0, totalSize) : nullptr;
+    if (!image) {
+        emit errorMessage(tr("Failed to open file: %1").arg(fileName));
+        return false;
+    }
     emit statusMessage(tr("Starting firmware upgrade, size: %1 bytes").arg(totalSize));
 
     // Send start update command
@@ -226,13 +232,13 @@ bool CanManager::firmwareUpgrade(const QString &fileName, bool testMode)
 
     // Send firmware data
     qint64 bytesSent = 0;
-    char buffer[8];
 
-    while (!file.atEnd()) {
-        qint64 bytesRead = file.read(buffer, 8);
-        if (bytesRead <= 0) break;
+    while (bytesSent < totalSize) {
+        qint64 bytesRead = qMin<qint64>(8, totalSize - bytesSent);
 
-        QByteArray chunk(buffer, bytesRead);
+        // Deep copy: the backend may queue the frame beyond the lifetime of the mapping
+        const QByteArray chunk(reinterpret_cast<const char *>(image + bytesSent),
+                               static_cast<int>(bytesRead));
         if (!sendData(chunk)) {
             file.close();
             emit errorMessage(tr("Failed to send data frame"));
@@ -1,4 +1,5 @@
 #include "udp_manager.h"
+#include "crc_nibble.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -567,20 +568,9 @@ static int fw_exchange(UdpManager *mgr, uint8_t cmd,
 
 uint16_t UdpManager_CRC16_CCITT(const uint8_t *data, size_t len)
 {
-	/* 与 Zephyr crc16_ccitt (subsys/crc/crc16_sw.c) 完全一致的实现.
+	/* 与 Zephyr crc16_ccitt (subsys/crc/crc16_sw.c) 结果一致, seed 0 即 CRC-16/KERMIT.
 	 * 注意: 这是 Zephyr 特化的 bit-reflected 变体, 非标准 MSB-first CCITT. */
-	uint16_t seed = 0x0000;
-
-	for (; len > 0; len--) {
-		uint8_t e, f;
-
-		e = (uint8_t)seed ^ *data;
-		++data;
-		f = (uint8_t)(e ^ (e << 4));
-		seed = (uint16_t)((seed >> 8) ^ ((uint16_t)f << 8) ^ ((uint16_t)f << 3) ^
-				  ((uint16_t)f >> 4));
-	}
-	return seed;
+	return crc16_ccitt_zephyr_nibble(0x0000, data, len);
 }
 
 bool UdpManager_FirmwareStart(UdpManager *mgr, uint32_t size)
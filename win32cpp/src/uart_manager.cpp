@@ -1,4 +1,5 @@
 #include "uart_manager.h"
+#include "crc_nibble.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -10,20 +11,9 @@
 // 需要链接 setupapi.lib
 #pragma comment(lib, "setupapi.lib")
 
-// CRC16-CCITT 计算函数
+// 帧 CRC16（MODBUS：反向 0xA001，初值 0xFFFF），与固件 UART_CalcCRC16 一致
 static uint16_t CalcCRC16(const uint8_t* data, int len) {
-    uint16_t crc = 0xFFFF;
-    for (int i = 0; i < len; i++) {
-        crc ^= data[i];
-        for (int j = 0; j < 8; j++) {
-            if (crc & 0x0001) {
-                crc = (crc >> 1) ^ 0xA001;
-            } else {
-                crc >>= 1;
-            }
-        }
-    }
-    return crc;
+    return crc16_modbus_nibble(data, static_cast<size_t>(len));
 }
 
 // 内部结构定义